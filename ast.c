@@ -1,21 +1,22 @@
 #include "ast.h"
 
-Expression *create_number_expr(int value) {
-    Expression *expr = (Expression *)malloc(sizeof(Expression));
+Expression *create_number_expr(Arena *arena, int value) {
+    Expression *expr = (Expression *)arena_alloc(arena, sizeof(Expression));
     expr->type = EXPR_NUMBER;
     expr->data.number = value;
     return expr;
 }
 
-Expression *create_identifier_expr(char *name) {
-    Expression *expr = (Expression *)malloc(sizeof(Expression));
+Expression *create_identifier_expr(Arena *arena, Symbol *symbol) {
+    Expression *expr = (Expression *)arena_alloc(arena, sizeof(Expression));
     expr->type = EXPR_IDENTIFIER;
-    expr->data.identifier = strdup(name);
+    expr->data.identifier.symbol = symbol;
+    expr->data.identifier.slot = -1;
     return expr;
 }
 
-Expression *create_binary_expr(BinaryOp op, Expression *left, Expression *right) {
-    Expression *expr = (Expression *)malloc(sizeof(Expression));
+Expression *create_binary_expr(Arena *arena, BinaryOp op, Expression *left, Expression *right) {
+    Expression *expr = (Expression *)arena_alloc(arena, sizeof(Expression));
     expr->type = EXPR_BINARY_OP;
     expr->data.binary.op = op;
     expr->data.binary.left = left;
@@ -23,49 +24,26 @@ Expression *create_binary_expr(BinaryOp op, Expression *left, Expression *right)
     return expr;
 }
 
-void free_expression(Expression *expr) {
-    if (!expr) return;
-    
-    switch (expr->type) {
-        case EXPR_IDENTIFIER:
-            free(expr->data.identifier);
-            break;
-        case EXPR_BINARY_OP:
-            free_expression(expr->data.binary.left);
-            free_expression(expr->data.binary.right);
-            break;
-        case EXPR_NUMBER:
-            break;
-    }
-    free(expr);
-}
-
-Condition *create_condition(RelOp op, Expression *left, Expression *right) {
-    Condition *cond = (Condition *)malloc(sizeof(Condition));
+Condition *create_condition(Arena *arena, RelOp op, Expression *left, Expression *right) {
+    Condition *cond = (Condition *)arena_alloc(arena, sizeof(Condition));
     cond->op = op;
     cond->left = left;
     cond->right = right;
     return cond;
 }
 
-void free_condition(Condition *cond) {
-    if (!cond) return;
-    free_expression(cond->left);
-    free_expression(cond->right);
-    free(cond);
-}
-
-ASTNode *create_assignment(char *var_name, Expression *expr) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_assignment(Arena *arena, Symbol *var, Expression *expr) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_ASSIGNMENT;
-    node->data.assignment.var_name = strdup(var_name);
+    node->data.assignment.var = var;
+    node->data.assignment.slot = -1;
     node->data.assignment.expr = expr;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_if_stmt(Condition *cond, ASTNode *then_block, ASTNode *else_block) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_if_stmt(Arena *arena, Condition *cond, ASTNode *then_block, ASTNode *else_block) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_IF;
     node->data.if_stmt.condition = cond;
     node->data.if_stmt.then_block = then_block;
@@ -74,8 +52,8 @@ ASTNode *create_if_stmt(Condition *cond, ASTNode *then_block, ASTNode *else_bloc
     return node;
 }
 
-ASTNode *create_while_stmt(Condition *cond, ASTNode *body) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_while_stmt(Arena *arena, Condition *cond, ASTNode *body) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_WHILE;
     node->data.while_stmt.condition = cond;
     node->data.while_stmt.body = body;
@@ -83,65 +61,66 @@ ASTNode *create_while_stmt(Condition *cond, ASTNode *body) {
     return node;
 }
 
-ASTNode *create_speed_cmd(Expression *expr) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_speed_cmd(Arena *arena, Expression *expr) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_SPEED;
     node->data.speed_cmd.expr = expr;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_torque_cmd(Expression *expr) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_torque_cmd(Arena *arena, Expression *expr) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_TORQUE;
     node->data.torque_cmd.expr = expr;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_yaw_cmd(Expression *expr) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_yaw_cmd(Arena *arena, Expression *expr) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_YAW;
     node->data.yaw_cmd.expr = expr;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_brake_cmd(Expression *expr) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_brake_cmd(Arena *arena, Expression *expr) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_BRAKE;
     node->data.brake_cmd.expr = expr;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_wait_cmd(Expression *expr) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_wait_cmd(Arena *arena, Expression *expr) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_WAIT;
     node->data.wait_cmd.expr = expr;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_pattern_cmd(Pattern pattern) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_pattern_cmd(Arena *arena, Pattern pattern) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_PATTERN;
     node->data.pattern_cmd.pattern = pattern;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_sensor_read(SensorType sensor, char *var_name) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_sensor_read(Arena *arena, SensorType sensor, Symbol *var) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_SENSOR_READ;
     node->data.sensor_read.sensor = sensor;
-    node->data.sensor_read.var_name = strdup(var_name);
+    node->data.sensor_read.var = var;
+    node->data.sensor_read.slot = -1;
     node->next = NULL;
     return node;
 }
 
-ASTNode *create_block(ASTNode **statements, int count) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+ASTNode *create_block(Arena *arena, ASTNode **statements, int count) {
+    ASTNode *node = (ASTNode *)arena_alloc(arena, sizeof(ASTNode));
     node->type = STMT_BLOCK;
     node->data.block.statements = statements;
     node->data.block.count = count;
@@ -149,76 +128,139 @@ ASTNode *create_block(ASTNode **statements, int count) {
     return node;
 }
 
-void free_ast(ASTNode *node) {
-    if (!node) return;
+void append_statement(StatementList *list, ASTNode *stmt) {
+    if (!stmt) return;
     
+    if (!list->head) {
+        list->head = stmt;
+    } else {
+        list->tail->next = stmt;
+    }
+    list->tail = stmt;
+}
+
+static void dump_expression(FILE *out, Expression *expr) {
+    const char op_symbol[] = {'+', '-', '*', '/'};
+
+    if (!expr) {
+        fprintf(out, "?");
+        return;
+    }
+
+    switch (expr->type) {
+        case EXPR_NUMBER:
+            fprintf(out, "%d", expr->data.number);
+            break;
+        case EXPR_IDENTIFIER:
+            fprintf(out, "%s", expr->data.identifier.symbol->name);
+            break;
+        case EXPR_BINARY_OP:
+            fprintf(out, "(%c ", op_symbol[expr->data.binary.op]);
+            dump_expression(out, expr->data.binary.left);
+            fprintf(out, " ");
+            dump_expression(out, expr->data.binary.right);
+            fprintf(out, ")");
+            break;
+    }
+}
+
+static void dump_condition(FILE *out, Condition *cond) {
+    const char *rel_symbol[] = {"==", "!=", ">", "<", ">=", "<="};
+
+    fprintf(out, "(%s ", rel_symbol[cond->op]);
+    dump_expression(out, cond->left);
+    fprintf(out, " ");
+    dump_expression(out, cond->right);
+    fprintf(out, ")");
+}
+
+static void dump_list(FILE *out, ASTNode *list, int depth);
+
+static void dump_statement(FILE *out, ASTNode *node, int depth) {
+    const char *pattern_name[] = {"CALM", "SWIRL", "AGGRESSIVE"};
+    const char *sensor_name[] = {"rider", "tilt", "rpm", "emergency", "time_ms", "time_us"};
+
+    fprintf(out, "%*s", depth * 2, "");
     switch (node->type) {
         case STMT_ASSIGNMENT:
-            free(node->data.assignment.var_name);
-            free_expression(node->data.assignment.expr);
+            fprintf(out, "%s = ", node->data.assignment.var->name);
+            dump_expression(out, node->data.assignment.expr);
+            fprintf(out, "\n");
             break;
-            
+
         case STMT_IF:
-            free_condition(node->data.if_stmt.condition);
-            free_ast(node->data.if_stmt.then_block);
-            free_ast(node->data.if_stmt.else_block);
+            fprintf(out, "if ");
+            dump_condition(out, node->data.if_stmt.condition);
+            fprintf(out, "\n");
+            dump_list(out, node->data.if_stmt.then_block, depth + 1);
+            if (node->data.if_stmt.else_block) {
+                fprintf(out, "%*selse\n", depth * 2, "");
+                dump_list(out, node->data.if_stmt.else_block, depth + 1);
+            }
             break;
-            
+
         case STMT_WHILE:
-            free_condition(node->data.while_stmt.condition);
-            free_ast(node->data.while_stmt.body);
+            fprintf(out, "while ");
+            dump_condition(out, node->data.while_stmt.condition);
+            fprintf(out, "\n");
+            dump_list(out, node->data.while_stmt.body, depth + 1);
             break;
-            
+
         case STMT_SPEED:
-            free_expression(node->data.speed_cmd.expr);
+            fprintf(out, "speed ");
+            dump_expression(out, node->data.speed_cmd.expr);
+            fprintf(out, "\n");
             break;
-            
+
         case STMT_TORQUE:
-            free_expression(node->data.torque_cmd.expr);
+            fprintf(out, "torque ");
+            dump_expression(out, node->data.torque_cmd.expr);
+            fprintf(out, "\n");
             break;
-            
+
         case STMT_YAW:
-            free_expression(node->data.yaw_cmd.expr);
+            fprintf(out, "yaw ");
+            dump_expression(out, node->data.yaw_cmd.expr);
+            fprintf(out, "\n");
             break;
-            
+
         case STMT_BRAKE:
-            free_expression(node->data.brake_cmd.expr);
+            fprintf(out, "brake ");
+            dump_expression(out, node->data.brake_cmd.expr);
+            fprintf(out, "\n");
             break;
-            
+
         case STMT_WAIT:
-            free_expression(node->data.wait_cmd.expr);
+            fprintf(out, "wait ");
+            dump_expression(out, node->data.wait_cmd.expr);
+            fprintf(out, "\n");
             break;
-            
-        case STMT_PATTERN:  
+
+        case STMT_PATTERN:
+            fprintf(out, "pattern %s\n", pattern_name[node->data.pattern_cmd.pattern]);
             break;
-            
+
         case STMT_SENSOR_READ:
-            free(node->data.sensor_read.var_name);
+            fprintf(out, "read %s -> %s\n",
+                    sensor_name[node->data.sensor_read.sensor],
+                    node->data.sensor_read.var->name);
             break;
-            
+
         case STMT_BLOCK:
+            fprintf(out, "block\n");
             for (int i = 0; i < node->data.block.count; i++) {
-                free_ast(node->data.block.statements[i]);
+                dump_statement(out, node->data.block.statements[i], depth + 1);
             }
-            free(node->data.block.statements);
             break;
     }
-    
-    free_ast(node->next);
-    free(node);
 }
 
-void append_statement(ASTNode **list, ASTNode *stmt) {
-    if (!stmt) return;
-    
-    if (!*list) {
-        *list = stmt;
-    } else {
-        ASTNode *current = *list;
-        while (current->next) {
-            current = current->next;
-        }
-        current->next = stmt;
+static void dump_list(FILE *out, ASTNode *list, int depth) {
+    for (ASTNode *node = list; node; node = node->next) {
+        dump_statement(out, node, depth);
     }
 }
 
+void dump_ast(FILE *out, ASTNode *program) {
+    dump_list(out, program, 0);
+}
@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include "arena.h"
+#include "intern.h"
 
 typedef struct ASTNode ASTNode;
 typedef struct Expression Expression;
@@ -41,14 +43,18 @@ typedef enum {
     SENSOR_TILT,
     SENSOR_RPM,
     SENSOR_EMERGENCY,
-    SENSOR_TIME_MS
+    SENSOR_TIME_MS,
+    SENSOR_TIME_US
 } SensorType;
 
 struct Expression {
     ExprType type;
     union {
         int number;
-        char *identifier;
+        struct {
+            Symbol *symbol;
+            int slot;
+        } identifier;
         struct {
             BinaryOp op;
             struct Expression *left;
@@ -81,7 +87,8 @@ struct ASTNode {
     StmtType type;
     union {
         struct {
-            char *var_name;
+            Symbol *var;
+            int slot;
             Expression *expr;
         } assignment;
         
@@ -122,7 +129,8 @@ struct ASTNode {
         
         struct {
             SensorType sensor;
-            char *var_name;
+            Symbol *var;
+            int slot;
         } sensor_read;
         
         struct {
@@ -134,28 +142,31 @@ struct ASTNode {
     ASTNode *next;
 };
 
-Expression *create_number_expr(int value);
-Expression *create_identifier_expr(char *name);
-Expression *create_binary_expr(BinaryOp op, Expression *left, Expression *right);
-void free_expression(Expression *expr);
-
-Condition *create_condition(RelOp op, Expression *left, Expression *right);
-void free_condition(Condition *cond);
-
-ASTNode *create_assignment(char *var_name, Expression *expr);
-ASTNode *create_if_stmt(Condition *cond, ASTNode *then_block, ASTNode *else_block);
-ASTNode *create_while_stmt(Condition *cond, ASTNode *body);
-ASTNode *create_speed_cmd(Expression *expr);
-ASTNode *create_torque_cmd(Expression *expr);
-ASTNode *create_yaw_cmd(Expression *expr);
-ASTNode *create_brake_cmd(Expression *expr);
-ASTNode *create_wait_cmd(Expression *expr);
-ASTNode *create_pattern_cmd(Pattern pattern);
-ASTNode *create_sensor_read(SensorType sensor, char *var_name);
-ASTNode *create_block(ASTNode **statements, int count);
-
-void free_ast(ASTNode *node);
-void append_statement(ASTNode **list, ASTNode *stmt);
+typedef struct {
+    ASTNode *head;
+    ASTNode *tail;
+} StatementList;
+
+Expression *create_number_expr(Arena *arena, int value);
+Expression *create_identifier_expr(Arena *arena, Symbol *symbol);
+Expression *create_binary_expr(Arena *arena, BinaryOp op, Expression *left, Expression *right);
+
+Condition *create_condition(Arena *arena, RelOp op, Expression *left, Expression *right);
+
+ASTNode *create_assignment(Arena *arena, Symbol *var, Expression *expr);
+ASTNode *create_if_stmt(Arena *arena, Condition *cond, ASTNode *then_block, ASTNode *else_block);
+ASTNode *create_while_stmt(Arena *arena, Condition *cond, ASTNode *body);
+ASTNode *create_speed_cmd(Arena *arena, Expression *expr);
+ASTNode *create_torque_cmd(Arena *arena, Expression *expr);
+ASTNode *create_yaw_cmd(Arena *arena, Expression *expr);
+ASTNode *create_brake_cmd(Arena *arena, Expression *expr);
+ASTNode *create_wait_cmd(Arena *arena, Expression *expr);
+ASTNode *create_pattern_cmd(Arena *arena, Pattern pattern);
+ASTNode *create_sensor_read(Arena *arena, SensorType sensor, Symbol *var);
+ASTNode *create_block(Arena *arena, ASTNode **statements, int count);
+
+void append_statement(StatementList *list, ASTNode *stmt);
+void dump_ast(FILE *out, ASTNode *program);
 
 #endif
 
@@ -0,0 +1,124 @@
+#include "backend.h"
+#include <stdio.h>
+
+static int replay_read_sensor(VMContext *ctx, SensorType sensor) {
+    ReplayBackend *replay = (ReplayBackend *)ctx->backend_data;
+    const TelemetrySample *sample = telemetry_lookup(replay->telemetry, ctx->rodeo.sim_time_ms,
+                                                     &replay->cursor);
+    switch (sensor) {
+        case SENSOR_RIDER: return sample->rider_present;
+        case SENSOR_TILT: return sample->tilt_angle;
+        case SENSOR_RPM: return sample->rpm;
+        case SENSOR_EMERGENCY: return sample->emergency;
+        default: return 0;
+    }
+}
+
+static void replay_commit(VMContext *ctx, const VMFrame *frame) {
+    (void)ctx;
+    (void)frame;
+}
+
+static void replay_wait(VMContext *ctx, int ms) {
+    (void)ctx;
+    (void)ms;
+}
+
+const VMBackend backend_replay = {
+    "replay",
+    replay_read_sensor,
+    replay_commit,
+    replay_wait,
+};
+
+void backend_replay_init(ReplayBackend *replay, const Telemetry *telemetry) {
+    replay->telemetry = telemetry;
+    replay->cursor = 0;
+}
+
+static void channel_lost(ChannelBackend *backend) {
+    if (!backend->lost) {
+        fprintf(stderr, "Error: driver on %s stopped responding\n", backend->channel->name);
+        backend->lost = 1;
+    }
+}
+
+static void channel_send(ChannelBackend *backend, const ChannelCommand *commands, int count) {
+    if (backend->lost) return;
+    if (channel_push_frame(backend->channel->shared, commands, count) != 0) channel_lost(backend);
+}
+
+static int channel_read_sensor(VMContext *ctx, SensorType sensor) {
+    ChannelBackend *backend = (ChannelBackend *)ctx->backend_data;
+    ChannelShared *shared = backend->channel->shared;
+    ChannelSensors sensors;
+
+    if (backend->lost) {
+        return sensor == SENSOR_EMERGENCY ? 1 : 0;
+    }
+    int status;
+    if (backend->sync) {
+        unsigned long sent = atomic_load_explicit(&shared->head, memory_order_relaxed);
+        status = channel_snapshot_after(shared, sent, &sensors);
+    } else {
+        status = channel_snapshot(shared, &sensors);
+    }
+    if (status != 0) {
+        channel_lost(backend);
+        return sensor == SENSOR_EMERGENCY ? 1 : 0;
+    }
+
+    switch (sensor) {
+        case SENSOR_RIDER: return sensors.rider_present;
+        case SENSOR_TILT: return sensors.tilt_angle;
+        case SENSOR_RPM: return sensors.rpm;
+        case SENSOR_EMERGENCY: return sensors.emergency;
+        default: return 0;
+    }
+}
+
+// One ring entry per changed actuator, published together
+static void channel_commit(VMContext *ctx, const VMFrame *frame) {
+    ChannelCommand commands[5];
+    int count = 0;
+    if (frame->changed & VM_FRAME_SPEED) {
+        commands[count++] = (ChannelCommand){CHANNEL_SPEED, frame->speed};
+    }
+    if (frame->changed & VM_FRAME_TORQUE) {
+        commands[count++] = (ChannelCommand){CHANNEL_TORQUE, frame->torque};
+    }
+    if (frame->changed & VM_FRAME_YAW) {
+        commands[count++] = (ChannelCommand){CHANNEL_YAW, frame->yaw};
+    }
+    if (frame->changed & VM_FRAME_BRAKE) {
+        commands[count++] = (ChannelCommand){CHANNEL_BRAKE, frame->brake};
+    }
+    if (frame->changed & VM_FRAME_PATTERN) {
+        commands[count++] = (ChannelCommand){CHANNEL_PATTERN, frame->pattern};
+    }
+    channel_send((ChannelBackend *)ctx->backend_data, commands, count);
+}
+
+static void channel_wait(VMContext *ctx, int ms) {
+    ChannelCommand command = {CHANNEL_WAIT, ms};
+    channel_send((ChannelBackend *)ctx->backend_data, &command, 1);
+}
+
+const VMBackend backend_channel = {
+    "channel",
+    channel_read_sensor,
+    channel_commit,
+    channel_wait,
+};
+
+void backend_channel_init(ChannelBackend *backend, Channel *channel, int sync) {
+    backend->channel = channel;
+    backend->sync = sync;
+    backend->lost = 0;
+}
+
+void backend_channel_detach(ChannelBackend *backend) {
+    if (!backend->lost && channel_push(backend->channel->shared, CHANNEL_DETACH, 0) != 0) {
+        channel_lost(backend);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include "channel.h"
+#include "telemetry.h"
+#include "vm.h"
+
+// Backends other than the built-in simulator. Attach one with
+// vm_set_backend(ctx, &backend_x, &state); the state outlives the run.
+
+// Serves rider, tilt, rpm and emergency from a recording at the simulated
+// time; commands only update RodeoState.
+typedef struct {
+    const Telemetry *telemetry;
+    long long cursor;
+} ReplayBackend;
+
+extern const VMBackend backend_replay;
+
+void backend_replay_init(ReplayBackend *replay, const Telemetry *telemetry);
+
+// Hands commands to a driver process through a shared-memory channel and
+// reads the sensors it publishes, without a syscall on either path. Reads see
+// the latest snapshot; with `sync` they first wait until the driver has
+// applied every command sent so far. If the driver goes away, commands are
+// dropped and the emergency sensor reads 1.
+typedef struct {
+    Channel *channel;
+    int sync;
+    int lost;
+} ChannelBackend;
+
+extern const VMBackend backend_channel;
+
+void backend_channel_init(ChannelBackend *backend, Channel *channel, int sync);
+
+// Tells the driver the run is over
+void backend_channel_detach(ChannelBackend *backend);
+
+#endif
@@ -0,0 +1,291 @@
+#include "batch.h"
+#include "image.h"
+#include "lockstep.h"
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+// Each worker owns a contiguous slice of the job array. The owner takes jobs
+// from the tail of its slice and idle workers steal from the head of others.
+typedef struct {
+    pthread_mutex_t lock;
+    int head;
+    int tail;
+} WorkQueue;
+
+typedef void (*BatchTask)(void *data, int index);
+
+typedef struct {
+    BatchTask task;
+    void *data;
+    WorkQueue *queues;
+    int worker_count;
+} BatchPool;
+
+typedef struct {
+    BatchPool *pool;
+    int id;
+} Worker;
+
+static int has_suffix(const char *s, const char *suffix) {
+    size_t len = strlen(s);
+    size_t suffix_len = strlen(suffix);
+    return len >= suffix_len && strcmp(s + len - suffix_len, suffix) == 0;
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static void add_source(char ***sources, int *count, int *capacity, char *path) {
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 16;
+        *sources = (char **)realloc(*sources, sizeof(char *) * *capacity);
+    }
+    (*sources)[(*count)++] = path;
+}
+
+char **batch_collect_sources(char **paths, int count, int *out_count) {
+    char **sources = NULL;
+    int total = 0;
+    int capacity = 0;
+
+    for (int i = 0; i < count; i++) {
+        struct stat st;
+        if (stat(paths[i], &st) != 0 || !S_ISDIR(st.st_mode)) {
+            add_source(&sources, &total, &capacity, strdup(paths[i]));
+            continue;
+        }
+
+        DIR *dir = opendir(paths[i]);
+        if (!dir) {
+            perror(paths[i]);
+            continue;
+        }
+
+        int first = total;
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (!has_suffix(entry->d_name, ".rodeo") && !has_suffix(entry->d_name, ".rbc")) continue;
+
+            size_t len = strlen(paths[i]) + strlen(entry->d_name) + 2;
+            char *path = (char *)malloc(len);
+            snprintf(path, len, "%s/%s", paths[i], entry->d_name);
+            add_source(&sources, &total, &capacity, path);
+        }
+        closedir(dir);
+
+        qsort(sources + first, total - first, sizeof(char *), compare_paths);
+    }
+
+    *out_count = total;
+    return sources;
+}
+
+void batch_free_sources(char **sources, int count) {
+    for (int i = 0; i < count; i++) {
+        free(sources[i]);
+    }
+    free(sources);
+}
+
+static int take_local(WorkQueue *queue) {
+    int index = -1;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail) {
+        index = --queue->tail;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return index;
+}
+
+static int steal(WorkQueue *queue) {
+    int index = -1;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail) {
+        index = queue->head++;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return index;
+}
+
+typedef struct {
+    BatchProgram *programs;
+    ScannerKind scanner;
+    int optimize;
+    unsigned int fuse;
+} LoadTask;
+
+static void load_program(void *data, int index) {
+    LoadTask *load = (LoadTask *)data;
+    BatchProgram *entry = &load->programs[index];
+
+    if (image_probe(entry->path)) {
+        entry->code = image_load(entry->path);
+        return;
+    }
+    entry->program = rodeo_parse_file(entry->path, load->scanner);
+    if (!entry->program->failed) {
+        entry->code = rodeo_compile(entry->program, load->optimize, load->fuse);
+    }
+}
+
+static void run_job(void *data, int index) {
+    BatchJob *job = &((BatchJob *)data)[index];
+    if (job->status != 0 || !job->code) return;
+
+    VMContext vm;
+    vm_init(&vm, TRACE_OFF);
+    vm.seed = job->seed;
+    if (vm_run_bytecode(&vm, job->code) != 0) {
+        job->status = -1;
+    } else {
+        job->final = vm.rodeo;
+    }
+    vm_cleanup(&vm);
+}
+
+static void *worker_main(void *arg) {
+    Worker *worker = (Worker *)arg;
+    BatchPool *pool = worker->pool;
+
+    for (;;) {
+        int index = take_local(&pool->queues[worker->id]);
+
+        // No job is ever added after start, so an empty sweep means we are done
+        for (int k = 1; index < 0 && k < pool->worker_count; k++) {
+            index = steal(&pool->queues[(worker->id + k) % pool->worker_count]);
+        }
+        if (index < 0) break;
+
+        pool->task(pool->data, index);
+    }
+    return NULL;
+}
+
+static void run_pool(BatchTask task, void *data, int count, int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count;
+    if (threads == 0) return;
+
+    BatchPool pool;
+    pool.task = task;
+    pool.data = data;
+    pool.worker_count = threads;
+    pool.queues = (WorkQueue *)malloc(sizeof(WorkQueue) * threads);
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+        pool.queues[i].head = (int)((long)count * i / threads);
+        pool.queues[i].tail = (int)((long)count * (i + 1) / threads);
+    }
+
+    pthread_t *handles = (pthread_t *)malloc(sizeof(pthread_t) * threads);
+    Worker *workers = (Worker *)malloc(sizeof(Worker) * threads);
+
+    for (int i = 0; i < threads; i++) {
+        workers[i].pool = &pool;
+        workers[i].id = i;
+    }
+    for (int i = 1; i < threads; i++) {
+        pthread_create(&handles[i], NULL, worker_main, &workers[i]);
+    }
+    worker_main(&workers[0]);
+    for (int i = 1; i < threads; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&pool.queues[i].lock);
+    }
+    free(workers);
+    free(handles);
+    free(pool.queues);
+}
+
+void batch_load(BatchProgram *programs, int count, int threads, ScannerKind scanner,
+                int optimize, unsigned int fuse) {
+    LoadTask load;
+    load.programs = programs;
+    load.scanner = scanner;
+    load.optimize = optimize;
+    load.fuse = fuse;
+    run_pool(load_program, &load, count, threads);
+}
+
+void batch_run(BatchJob *jobs, int count, int threads) {
+    run_pool(run_job, jobs, count, threads);
+}
+
+typedef struct {
+    BatchJob *jobs;
+    int count;
+} LaneGroup;
+
+static void run_group(void *data, int index) {
+    LaneGroup *group = &((LaneGroup *)data)[index];
+    Fleet fleet;
+    fleet_init(&fleet, group->count);
+    for (int i = 0; i < group->count; i++) {
+        fleet.seed[i] = group->jobs[i].seed;
+    }
+
+    int status = lockstep_run(&fleet, group->jobs[0].code);
+
+    for (int i = 0; i < group->count; i++) {
+        if (status != 0) {
+            group->jobs[i].status = -1;
+        } else {
+            fleet_get_state(&fleet, i, &group->jobs[i].final);
+        }
+    }
+    fleet_free(&fleet);
+}
+
+// Consecutive instances of the same program become one lane group; groups are
+// capped so the pool still has work to spread over its threads.
+void batch_run_lockstep(BatchJob *jobs, int count, int threads) {
+    LaneGroup *groups = (LaneGroup *)malloc(sizeof(LaneGroup) * (count + 1));
+    int group_count = 0;
+
+    for (int i = 0; i < count; ) {
+        if (jobs[i].status != 0 || !jobs[i].code) {
+            i++;
+            continue;
+        }
+
+        int n = 1;
+        while (i + n < count && n < BATCH_GROUP_LANES &&
+               jobs[i + n].status == 0 && jobs[i + n].code == jobs[i].code) {
+            n++;
+        }
+        groups[group_count].jobs = &jobs[i];
+        groups[group_count].count = n;
+        group_count++;
+        i += n;
+    }
+
+    run_pool(run_group, groups, group_count, threads);
+    free(groups);
+}
+
+void batch_print_results(FILE *out, BatchJob *jobs, int count) {
+    const char *pattern_name[] = {"CALM", "SWIRL", "AGGRESSIVE"};
+
+    fprintf(out, "program,seed,status,speed,torque,yaw,brake,pattern,"
+                 "rider,tilt,rpm,emergency,time_ms\n");
+    for (int i = 0; i < count; i++) {
+        BatchJob *job = &jobs[i];
+        if (job->status != 0) {
+            fprintf(out, "%s,%u,error,,,,,,,,,,\n", job->path, job->seed);
+            continue;
+        }
+
+        RodeoState *s = &job->final;
+        fprintf(out, "%s,%u,ok,%d,%d,%d,%d,%s,%d,%d,%d,%d,%ld\n",
+                job->path, job->seed,
+                s->speed, s->torque, s->yaw, s->brake, pattern_name[s->pattern],
+                s->rider_present, s->tilt_angle, s->rpm, s->emergency,
+                s->sim_time_ms);
+    }
+}
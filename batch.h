@@ -0,0 +1,34 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "compiler.h"
+#include "frontend.h"
+#include "vm.h"
+
+#define BATCH_GROUP_LANES 256   // instances run together by --lockstep
+
+typedef struct {
+    const char *path;
+    RodeoProgram *program;  // kept for its diagnostics; NULL for images
+    Bytecode *code;         // NULL if the program failed to parse or compile
+} BatchProgram;
+
+typedef struct {
+    const char *path;
+    unsigned int seed;
+    Bytecode *code;         // shared by every instance of the same program
+    int status;             // 0 ok, -1 failed to load
+    RodeoState final;
+} BatchJob;
+
+char **batch_collect_sources(char **paths, int count, int *out_count);
+void batch_free_sources(char **sources, int count);
+
+void batch_load(BatchProgram *programs, int count, int threads, ScannerKind scanner,
+                int optimize, unsigned int fuse);
+void batch_run(BatchJob *jobs, int count, int threads);
+void batch_run_lockstep(BatchJob *jobs, int count, int threads);
+void batch_print_results(FILE *out, BatchJob *jobs, int count);
+
+#endif
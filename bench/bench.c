@@ -0,0 +1,377 @@
+// Benchmark harness: generates synthetic programs and measures the frontend
+// and the VM on each one. Every workload runs in its own process so that the
+// peak RSS and allocation counts belong to it alone.
+//
+//   make bench
+//   ./bench/bench [--scale=N] [--repeat=N] [--format=csv|json] [--output=FILE]
+//                 [--scanner=flex|fast] [--jit] [--workload=NAME]
+//
+// Link with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so that the
+// allocations made by the rodeo-vm objects are counted.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "frontend.h"
+#include "fuse.h"
+#include "vm.h"
+
+// Allocation counters
+
+static long allocation_count;
+static long allocation_bytes;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    allocation_count++;
+    allocation_bytes += (long)size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocation_count++;
+    allocation_bytes += (long)(count * size);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    allocation_count++;
+    allocation_bytes += (long)size;
+    return __real_realloc(pointer, size);
+}
+
+// Synthetic sources
+
+typedef struct {
+    char *text;
+    size_t length;
+    size_t capacity;
+    long statements;    // in the source
+    long executed;      // statements the VM runs, counting each loop iteration
+} Source;
+
+static void emit(Source *source, const char *format, ...) {
+    va_list args;
+    for (;;) {
+        va_start(args, format);
+        int n = vsnprintf(source->text + source->length, source->capacity - source->length,
+                          format, args);
+        va_end(args);
+        if (source->length + n < source->capacity) {
+            source->length += n;
+            return;
+        }
+        source->capacity = source->capacity ? source->capacity * 2 : 4096;
+        source->text = (char *)realloc(source->text, source->capacity);
+    }
+}
+
+// A long run of commands and assignments with no control flow
+static void generate_straight_line(Source *source, int scale) {
+    static const char *lines[] = {
+        "speed(v%d + 1);\n",
+        "torque(v%d * 2);\n",
+        "v%d = v%d + 3;\n",
+        "yaw(v%d - 4);\n",
+        "read(rpm) -> v%d;\n",
+        "brake(v%d / 5);\n",
+        "pattern(SWIRL);\n",
+        "wait(1);\n",
+    };
+    int count = 20000 * scale;
+    for (int i = 0; i < count; i++) {
+        int var = i % 16;
+        emit(source, lines[i % 8], var, var);
+    }
+    source->statements = source->executed = count;
+}
+
+// Ifs nested inside each other, all taken
+static void generate_deep_nesting(Source *source, int scale) {
+    int depth = 200 * scale;
+    emit(source, "x = 0;\n");
+    for (int i = 0; i < depth; i++) {
+        emit(source, "%*sif (x >= %d) {\n%*sx = x + 1;\n%*sspeed(x);\n",
+             i * 4, "", i, i * 4 + 4, "", i * 4 + 4, "");
+    }
+    for (int i = depth - 1; i >= 0; i--) {
+        emit(source, "%*s} else {\n%*sx = 0;\n%*s}\n", i * 4, "", i * 4 + 4, "", i * 4, "");
+    }
+    source->statements = 1 + depth * 4L;
+    source->executed = 1 + depth * 3L;
+}
+
+// Nested while loops with a one-statement body; both stay under the VM's
+// 10000-iteration guard
+static void generate_tight_loop(Source *source, int scale) {
+    int outer = 100 * scale;
+    int inner = 9000;
+    if (outer > 10000) outer = 10000;
+
+    emit(source, "j = 0;\n");
+    emit(source, "while (j < %d) {\n    i = 0;\n", outer);
+    emit(source, "    while (i < %d) {\n        i = i + 1;\n    }\n", inner);
+    emit(source, "    j = j + 1;\n}\n");
+    source->statements = 6;
+    source->executed = 2 + (long)outer * (3 + inner);
+}
+
+// Thousands of distinct variables, each assigned once from the previous one
+static void generate_many_variables(Source *source, int scale) {
+    int count = 5000 * scale;
+    emit(source, "v0 = 1;\n");
+    for (int i = 1; i < count; i++) {
+        emit(source, "v%d = v%d + %d;\n", i, i - 1, i % 7);
+    }
+    source->statements = source->executed = count;
+}
+
+typedef struct {
+    const char *name;
+    void (*generate)(Source *source, int scale);
+} Workload;
+
+static const Workload workloads[] = {
+    {"straight_line", generate_straight_line},
+    {"deep_nesting", generate_deep_nesting},
+    {"tight_loop", generate_tight_loop},
+    {"many_variables", generate_many_variables},
+};
+#define WORKLOAD_COUNT ((int)(sizeof(workloads) / sizeof(workloads[0])))
+
+// Measurement
+
+typedef struct {
+    int ok;
+    long source_bytes;
+    long statements;
+    long executed;
+    double parse_ms;        // best of the repetitions
+    double compile_ms;
+    double run_ms;
+    long parse_allocations; // parse and compile, first repetition
+    long parse_allocated_bytes;
+    long run_allocations;
+    long peak_rss_kb;
+} Result;
+
+typedef struct {
+    int scale;
+    int repeat;
+    ScannerKind scanner;
+    Engine engine;
+} Options;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void keep_best(double *best, double value, int first) {
+    if (first || value < *best) *best = value;
+}
+
+static void measure(const Workload *workload, const Options *options, Result *result) {
+    Source source = {0};
+    workload->generate(&source, options->scale);
+    result->source_bytes = (long)source.length;
+    result->statements = source.statements;
+    result->executed = source.executed;
+
+    for (int i = 0; i < options->repeat; i++) {
+        long allocations = allocation_count;
+        long bytes = allocation_bytes;
+
+        double start = now_ms();
+        RodeoProgram *program = rodeo_parse_buffer(source.text, source.length, options->scanner);
+        double parsed = now_ms();
+        if (program->failed) {
+            rodeo_print_diagnostics(stderr, program);
+            rodeo_free_program(program);
+            free(source.text);
+            return;
+        }
+        Bytecode *code = rodeo_compile(program, 1, FUSE_ALL);
+        double compiled = now_ms();
+        if (!code) {
+            rodeo_free_program(program);
+            free(source.text);
+            return;
+        }
+
+        keep_best(&result->parse_ms, parsed - start, i == 0);
+        keep_best(&result->compile_ms, compiled - parsed, i == 0);
+        if (i == 0) {
+            result->parse_allocations = allocation_count - allocations;
+            result->parse_allocated_bytes = allocation_bytes - bytes;
+        }
+
+        allocations = allocation_count;
+        VMContext vm;
+        vm_init(&vm, TRACE_OFF);
+        vm.engine = options->engine;
+        start = now_ms();
+        vm_run_bytecode(&vm, code);
+        keep_best(&result->run_ms, now_ms() - start, i == 0);
+        vm_cleanup(&vm);
+        if (i == 0) result->run_allocations = allocation_count - allocations;
+
+        free_bytecode(code);
+        rodeo_free_program(program);
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result->peak_rss_kb = usage.ru_maxrss;
+    result->ok = 1;
+    free(source.text);
+}
+
+// Runs one workload in a child process and reads its Result back
+static int run_isolated(const Workload *workload, const Options *options, Result *result) {
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+        perror("pipe");
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        Result child = {0};
+        close(pipe_fds[0]);
+        measure(workload, options, &child);
+        ssize_t written = write(pipe_fds[1], &child, sizeof(child));
+        _exit(written == (ssize_t)sizeof(child) ? 0 : 1);
+    }
+
+    close(pipe_fds[1]);
+    ssize_t got = read(pipe_fds[0], result, sizeof(*result));
+    close(pipe_fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (got != (ssize_t)sizeof(*result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        memset(result, 0, sizeof(*result));
+    }
+    return 0;
+}
+
+// Output
+
+static void print_csv(FILE *out, const Workload *workload, const Result *r, int header) {
+    if (header) {
+        fprintf(out, "workload,ok,source_bytes,statements,parse_ms,parse_ns_per_stmt,compile_ms,"
+                     "executed,run_ms,run_ns_per_stmt,parse_allocations,parse_allocated_bytes,"
+                     "run_allocations,peak_rss_kb\n");
+    }
+    fprintf(out, "%s,%d,%ld,%ld,%.3f,%.1f,%.3f,%ld,%.3f,%.2f,%ld,%ld,%ld,%ld\n",
+            workload->name, r->ok, r->source_bytes, r->statements,
+            r->parse_ms, r->statements ? r->parse_ms * 1e6 / r->statements : 0.0,
+            r->compile_ms, r->executed,
+            r->run_ms, r->executed ? r->run_ms * 1e6 / r->executed : 0.0,
+            r->parse_allocations, r->parse_allocated_bytes, r->run_allocations, r->peak_rss_kb);
+}
+
+static void print_json(FILE *out, const Workload *workload, const Result *r, int first) {
+    fprintf(out, "%s\n    {\"workload\": \"%s\", \"ok\": %s, \"source_bytes\": %ld, "
+                 "\"statements\": %ld, \"parse_ms\": %.3f, \"parse_ns_per_stmt\": %.1f, "
+                 "\"compile_ms\": %.3f, \"executed\": %ld, \"run_ms\": %.3f, "
+                 "\"run_ns_per_stmt\": %.2f, \"parse_allocations\": %ld, "
+                 "\"parse_allocated_bytes\": %ld, \"run_allocations\": %ld, "
+                 "\"peak_rss_kb\": %ld}",
+            first ? "" : ",", workload->name, r->ok ? "true" : "false", r->source_bytes,
+            r->statements, r->parse_ms,
+            r->statements ? r->parse_ms * 1e6 / r->statements : 0.0,
+            r->compile_ms, r->executed, r->run_ms,
+            r->executed ? r->run_ms * 1e6 / r->executed : 0.0,
+            r->parse_allocations, r->parse_allocated_bytes, r->run_allocations, r->peak_rss_kb);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--scale=N] [--repeat=N] [--format=csv|json] [--output=FILE] "
+                    "[--scanner=flex|fast] [--jit] [--workload=NAME]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    Options options = {1, 5, SCANNER_FLEX, ENGINE_INTERPRETER};
+    int json = 0;
+    const char *output = NULL;
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--scale=", 8) == 0) {
+            options.scale = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--repeat=", 9) == 0) {
+            options.repeat = atoi(argv[i] + 9);
+        } else if (strcmp(argv[i], "--format=csv") == 0) {
+            json = 0;
+        } else if (strcmp(argv[i], "--format=json") == 0) {
+            json = 1;
+        } else if (strncmp(argv[i], "--output=", 9) == 0) {
+            output = argv[i] + 9;
+        } else if (strcmp(argv[i], "--scanner=flex") == 0) {
+            options.scanner = SCANNER_FLEX;
+        } else if (strcmp(argv[i], "--scanner=fast") == 0) {
+            options.scanner = SCANNER_FAST;
+        } else if (strcmp(argv[i], "--jit") == 0) {
+            options.engine = ENGINE_JIT;
+        } else if (strncmp(argv[i], "--workload=", 11) == 0) {
+            only = argv[i] + 11;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.scale < 1 || options.repeat < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        perror(output);
+        return 1;
+    }
+
+    int failed = 0;
+    int printed = 0;
+    if (json) fprintf(out, "{\"scale\": %d, \"repeat\": %d, \"results\": [",
+                      options.scale, options.repeat);
+    for (int i = 0; i < WORKLOAD_COUNT; i++) {
+        if (only && strcmp(only, workloads[i].name) != 0) continue;
+
+        Result result = {0};
+        fflush(out);    // the child must not inherit buffered output
+        if (run_isolated(&workloads[i], &options, &result) != 0) break;
+        if (!result.ok) {
+            fprintf(stderr, "Error: workload %s failed\n", workloads[i].name);
+            failed = 1;
+        }
+        if (json) {
+            print_json(out, &workloads[i], &result, printed == 0);
+        } else {
+            print_csv(out, &workloads[i], &result, printed == 0);
+        }
+        printed++;
+    }
+    if (json) fprintf(out, "\n]}\n");
+
+    if (out != stdout) fclose(out);
+    if (only && printed == 0) {
+        fprintf(stderr, "Error: unknown workload %s\n", only);
+        return 1;
+    }
+    return failed;
+}
@@ -0,0 +1,86 @@
+// Scanner throughput: tokenizes a large synthetic script with the Flex scanner
+// and with the hand-written one and reports MB/s for each.
+//
+//   make bench-scanner                    (32 MB)
+//   ./bench/scanner_bench [megabytes] [repetitions]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "frontend.h"
+
+static const char *lines[] = {
+    "speed(v%d + 12);\n",
+    "torque(v%d * 3 - 1);\n",
+    "read(rpm) -> sensor_%d;\n",
+    "if (tilt_%d >= 40) { brake(1); } else { yaw(15); }\n",
+    "while (count_%d < 100) { count = count + 1; wait(10); }\n",
+    "// rider %d holds on\n",
+    "pattern(AGGRESSIVE);\n",
+    "v%d = (rider + emergency) / 2;\n",
+};
+
+static char *generate(size_t size, size_t *length) {
+    char *source = (char *)malloc(size + 128);
+    size_t used = 0;
+    unsigned int state = 12345;
+
+    while (used < size) {
+        state = state * 1103515245u + 12345u;
+        const char *line = lines[(state >> 16) % (sizeof(lines) / sizeof(lines[0]))];
+        used += (size_t)snprintf(source + used, 128, line, (int)((state >> 8) % 256));
+    }
+    *length = used;
+    return source;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Best of `repetitions` runs
+static double measure(const char *source, size_t length, ScannerKind scanner,
+                      int repetitions, long *tokens) {
+    double best = 0;
+    for (int i = 0; i < repetitions; i++) {
+        double start = now_seconds();
+        *tokens = rodeo_scan_buffer(source, length, scanner);
+        double elapsed = now_seconds() - start;
+        if (i == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    int megabytes = argc > 1 ? atoi(argv[1]) : 32;
+    int repetitions = argc > 2 ? atoi(argv[2]) : 5;
+    if (megabytes < 1 || repetitions < 1) {
+        fprintf(stderr, "Usage: %s [megabytes] [repetitions]\n", argv[0]);
+        return 1;
+    }
+
+    size_t length;
+    char *source = generate((size_t)megabytes << 20, &length);
+    const char *names[] = {"flex", "fast"};
+    double seconds[2];
+    long tokens[2];
+
+    printf("%-8s %10s %12s %12s\n", "scanner", "MB/s", "Mtokens/s", "tokens");
+    for (int kind = SCANNER_FLEX; kind <= SCANNER_FAST; kind++) {
+        seconds[kind] = measure(source, length, (ScannerKind)kind, repetitions, &tokens[kind]);
+        printf("%-8s %10.1f %12.1f %12ld\n", names[kind],
+               length / seconds[kind] / (1 << 20), tokens[kind] / seconds[kind] / 1e6,
+               tokens[kind]);
+    }
+    printf("speedup  %10.2fx\n", seconds[SCANNER_FLEX] / seconds[SCANNER_FAST]);
+
+    free(source);
+    if (tokens[SCANNER_FLEX] != tokens[SCANNER_FAST]) {
+        fprintf(stderr, "Error: the scanners disagree on the token count\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include "channel.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#else
+#define cpu_relax() ((void)0)
+#endif
+
+// Spinning only helps when the other process runs on another CPU
+static long spin_limit = 1000;
+
+// Retries before a snapshot gives up on a seqlock write that never finishes;
+// the driver holds it for a handful of stores
+#define SNAPSHOT_RETRIES 1000000
+
+static int process_gone(int pid) {
+    return kill(pid, 0) != 0 && errno == ESRCH;
+}
+
+static Channel *map_channel(const char *name, int create) {
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2) spin_limit = 0;
+
+    Channel *channel = (Channel *)calloc(1, sizeof(Channel));
+    snprintf(channel->name, sizeof(channel->name), "%s%s", name[0] == '/' ? "" : "/", name);
+
+    int fd = shm_open(channel->name, create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "Error: shared memory %s: %s\n", channel->name, strerror(errno));
+        free(channel);
+        return NULL;
+    }
+
+    struct stat st;
+    if ((create && ftruncate(fd, sizeof(ChannelShared)) != 0) ||
+        fstat(fd, &st) != 0 || (size_t)st.st_size != sizeof(ChannelShared)) {
+        fprintf(stderr, "Error: shared memory %s is not a rodeo channel\n", channel->name);
+        close(fd);
+        if (create) shm_unlink(channel->name);
+        free(channel);
+        return NULL;
+    }
+
+    void *base = mmap(NULL, sizeof(ChannelShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Error: shared memory %s: %s\n", channel->name, strerror(errno));
+        if (create) shm_unlink(channel->name);
+        free(channel);
+        return NULL;
+    }
+
+    channel->shared = (ChannelShared *)base;
+    channel->owner = create;
+    return channel;
+}
+
+Channel *channel_create(const char *name) {
+    Channel *channel = map_channel(name, 1);
+    if (!channel) return NULL;
+
+    // A fresh segment is zero-filled: empty ring, even sequence
+    ChannelShared *shared = channel->shared;
+    shared->version = CHANNEL_VERSION;
+    shared->driver_pid = getpid();
+    atomic_thread_fence(memory_order_release);
+    shared->magic = CHANNEL_MAGIC;
+    return channel;
+}
+
+Channel *channel_open(const char *name) {
+    Channel *channel = map_channel(name, 0);
+    if (!channel) return NULL;
+
+    ChannelShared *shared = channel->shared;
+    const char *problem = NULL;
+    if (shared->magic != CHANNEL_MAGIC || shared->version != CHANNEL_VERSION) {
+        problem = "is not a rodeo channel";
+    }
+
+    // A pid left behind by a VM that died attached is taken over
+    int holder = 0;
+    while (!problem && !atomic_compare_exchange_strong(&shared->vm_pid, &holder, getpid())) {
+        if (holder != 0 && !process_gone(holder)) problem = "is already in use";
+    }
+    // Marks where this session starts, in case the last one never detached
+    if (!problem && channel_push(shared, CHANNEL_ATTACH, getpid()) != 0) {
+        atomic_store(&shared->vm_pid, 0);
+        problem = "has no driver";
+    }
+    if (problem) {
+        fprintf(stderr, "Error: shared memory %s %s\n", channel->name, problem);
+        munmap(shared, sizeof(ChannelShared));
+        free(channel);
+        return NULL;
+    }
+    return channel;
+}
+
+void channel_close(Channel *channel) {
+    if (!channel) return;
+    if (channel->owner) {
+        shm_unlink(channel->name);
+    } else {
+        atomic_store(&channel->shared->vm_pid, 0);
+    }
+    munmap(channel->shared, sizeof(ChannelShared));
+    free(channel);
+}
+
+// Called on every poll while waiting for the driver: spins first when there
+// is more than one CPU, then gives the driver the CPU if it shares ours, and
+// only now and then makes sure it is still running
+static int backoff(ChannelShared *shared, long *spins) {
+    long n = ++*spins;
+    if (n < spin_limit) {
+        cpu_relax();
+        return 0;
+    }
+    sched_yield();
+    if (n % 100000 == 0 && process_gone(shared->driver_pid)) return -1;
+    return 0;
+}
+
+int channel_reap(ChannelShared *shared) {
+    int holder = atomic_load(&shared->vm_pid);
+    if (holder == 0 || !process_gone(holder)) return 0;
+    return atomic_compare_exchange_strong(&shared->vm_pid, &holder, 0) ? holder : 0;
+}
+
+int channel_push_frame(ChannelShared *shared, const ChannelCommand *commands, int count) {
+    unsigned long head = atomic_load_explicit(&shared->head, memory_order_relaxed);
+
+    long spins = 0;
+    while (head + count - atomic_load_explicit(&shared->tail, memory_order_acquire) >
+           CHANNEL_RING_SIZE) {
+        if (backoff(shared, &spins) != 0) return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        *channel_command(shared, head + i) = commands[i];
+    }
+    atomic_store_explicit(&shared->head, head + count, memory_order_release);
+    return 0;
+}
+
+int channel_push(ChannelShared *shared, int kind, int value) {
+    ChannelCommand command = {kind, value};
+    return channel_push_frame(shared, &command, 1);
+}
+
+void channel_publish(ChannelShared *shared, const ChannelSensors *sensors) {
+    unsigned int sequence = atomic_load_explicit(&shared->sequence, memory_order_relaxed);
+    atomic_store_explicit(&shared->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&shared->rider_present, sensors->rider_present, memory_order_relaxed);
+    atomic_store_explicit(&shared->tilt_angle, sensors->tilt_angle, memory_order_relaxed);
+    atomic_store_explicit(&shared->rpm, sensors->rpm, memory_order_relaxed);
+    atomic_store_explicit(&shared->emergency, sensors->emergency, memory_order_relaxed);
+    atomic_store_explicit(&shared->applied, sensors->applied, memory_order_relaxed);
+
+    atomic_store_explicit(&shared->sequence, sequence + 2, memory_order_release);
+}
+
+int channel_snapshot(ChannelShared *shared, ChannelSensors *sensors) {
+    long spins = 0;
+    for (;;) {
+        unsigned int before = atomic_load_explicit(&shared->sequence, memory_order_acquire);
+        if (before & 1) {
+            if (backoff(shared, &spins) != 0 || spins >= SNAPSHOT_RETRIES) return -1;
+            continue;
+        }
+
+        sensors->rider_present = atomic_load_explicit(&shared->rider_present, memory_order_relaxed);
+        sensors->tilt_angle = atomic_load_explicit(&shared->tilt_angle, memory_order_relaxed);
+        sensors->rpm = atomic_load_explicit(&shared->rpm, memory_order_relaxed);
+        sensors->emergency = atomic_load_explicit(&shared->emergency, memory_order_relaxed);
+        sensors->applied = atomic_load_explicit(&shared->applied, memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&shared->sequence, memory_order_relaxed) == before) return 0;
+        if (backoff(shared, &spins) != 0 || spins >= SNAPSHOT_RETRIES) return -1;
+    }
+}
+
+int channel_snapshot_after(ChannelShared *shared, unsigned long position,
+                           ChannelSensors *sensors) {
+    long spins = 0;
+    if (channel_snapshot(shared, sensors) != 0) return -1;
+    while (sensors->applied < position) {
+        if (backoff(shared, &spins) != 0) return -1;
+        if (channel_snapshot(shared, sensors) != 0) return -1;
+    }
+    return 0;
+}
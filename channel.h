@@ -0,0 +1,105 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <stdatomic.h>
+
+#define CHANNEL_MAGIC 0x52434831u     // "RCH1"
+#define CHANNEL_VERSION 2
+#define CHANNEL_RING_SIZE 4096        // power of two
+#define CHANNEL_NAME_SIZE 64
+
+typedef enum {
+    CHANNEL_SPEED,
+    CHANNEL_TORQUE,
+    CHANNEL_YAW,
+    CHANNEL_BRAKE,
+    CHANNEL_PATTERN,
+    CHANNEL_WAIT,
+    CHANNEL_ATTACH,     // a VM starts its session; value is its pid
+    CHANNEL_DETACH      // the VM is done; value unused
+} ChannelCommandKind;
+
+typedef struct {
+    int kind;
+    int value;
+} ChannelCommand;
+
+typedef struct {
+    int rider_present;
+    int tilt_angle;
+    int rpm;
+    int emergency;
+    unsigned long applied;  // commands the driver had applied when it sampled
+} ChannelSensors;
+
+// The shared segment. Commands go from the VM (the only producer) to the
+// driver (the only consumer) through the ring; sensors go back as a seqlock
+// snapshot. The counters sit on their own cache lines so the two processes
+// do not invalidate each other's on every command.
+typedef struct {
+    unsigned int magic;
+    int version;
+    int driver_pid;     // checked when the VM has waited a long time on the driver
+    atomic_int vm_pid;  // the connected VM, 0 if none; there may only be one producer
+
+    _Alignas(64) atomic_ulong head;        // next command slot, written by the VM
+    _Alignas(64) atomic_ulong tail;        // next slot to apply, written by the driver
+    _Alignas(64) ChannelCommand commands[CHANNEL_RING_SIZE];
+
+    _Alignas(64) atomic_uint sequence;     // odd while the driver is writing sensors
+    atomic_int rider_present;
+    atomic_int tilt_angle;
+    atomic_int rpm;
+    atomic_int emergency;
+    atomic_ulong applied;
+} ChannelShared;
+
+typedef struct {
+    ChannelShared *shared;
+    char name[CHANNEL_NAME_SIZE];
+    int owner;          // created the segment and unlinks it on close
+} Channel;
+
+// The driver creates the segment, one VM at a time attaches to it. Names are
+// POSIX shared memory names; a leading '/' is added when missing. A VM that
+// exited without closing the channel does not keep others out.
+Channel *channel_create(const char *name);
+Channel *channel_open(const char *name);
+void channel_close(Channel *channel);
+
+// Driver side: if the attached VM has exited without detaching, frees the
+// channel for the next one and returns the dead VM's pid; otherwise 0.
+int channel_reap(ChannelShared *shared);
+
+// Producer side. Publishes the commands together, so the driver applies them
+// as one frame before it next samples the sensors. Spins while the ring is
+// full, so commands are never dropped; returns -1 only if the driver process
+// has gone away.
+int channel_push_frame(ChannelShared *shared, const ChannelCommand *commands, int count);
+int channel_push(ChannelShared *shared, int kind, int value);
+
+// Consumer side: the commands in [*from, returned position) are ready to apply.
+static inline unsigned long channel_available(ChannelShared *shared, unsigned long *from) {
+    *from = atomic_load_explicit(&shared->tail, memory_order_relaxed);
+    return atomic_load_explicit(&shared->head, memory_order_acquire);
+}
+
+static inline ChannelCommand *channel_command(ChannelShared *shared, unsigned long position) {
+    return &shared->commands[position & (CHANNEL_RING_SIZE - 1)];
+}
+
+static inline void channel_consume(ChannelShared *shared, unsigned long to) {
+    atomic_store_explicit(&shared->tail, to, memory_order_release);
+}
+
+// Seqlock: one writer (the driver), any number of readers, no locks or syscalls.
+// A snapshot returns -1 if the driver died or stalled in the middle of a write.
+void channel_publish(ChannelShared *shared, const ChannelSensors *sensors);
+int channel_snapshot(ChannelShared *shared, ChannelSensors *sensors);
+
+// A snapshot taken after the driver has applied the first `position` commands.
+// Returns -1 if the driver process has gone away.
+int channel_snapshot_after(ChannelShared *shared, unsigned long position,
+                           ChannelSensors *sensors);
+
+#endif
@@ -0,0 +1,107 @@
+#include "clock.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define CLOCK_HAVE_TSC 1
+#endif
+
+#ifndef CLOCK_MONOTONIC_COARSE
+#define CLOCK_MONOTONIC_COARSE CLOCK_MONOTONIC
+#endif
+
+static long read_posix(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+#ifdef CLOCK_HAVE_TSC
+// Ticks are converted as base_us + (ticks - base_ticks) * scale >> 32
+static struct {
+    int usable;
+    unsigned long long base_ticks;
+    long base_us;
+    unsigned long long scale;
+} tsc;
+static pthread_once_t tsc_once = PTHREAD_ONCE_INIT;
+
+// Measures the TSC rate against CLOCK_MONOTONIC over about 20 ms, once per process
+static void calibrate_tsc(void) {
+    unsigned int eax, ebx, ecx, edx;
+    // An invariant TSC ticks at a constant rate in every P- and C-state
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) return;
+
+    long start_us = read_posix(CLOCK_MONOTONIC);
+    unsigned long long start_ticks = __rdtsc();
+    struct timespec pause = {0, 20000000L};
+    nanosleep(&pause, NULL);
+    long end_us = read_posix(CLOCK_MONOTONIC);
+    unsigned long long end_ticks = __rdtsc();
+
+    if (end_ticks <= start_ticks || end_us <= start_us) return;
+    tsc.scale = (unsigned long long)(((unsigned __int128)(end_us - start_us) << 32) /
+                                     (end_ticks - start_ticks));
+    tsc.base_ticks = end_ticks;
+    tsc.base_us = end_us;
+    tsc.usable = 1;
+}
+
+// Another core's TSC may be slightly behind the one calibrated on; a reading
+// from before base_ticks counts as no time elapsed instead of wrapping around
+static long read_tsc(void) {
+    long long ticks = (long long)(__rdtsc() - tsc.base_ticks);
+    if (ticks < 0) ticks = 0;
+    return tsc.base_us + (long)(((unsigned __int128)ticks * tsc.scale) >> 32);
+}
+#endif
+
+void rodeo_clock_init(RodeoClock *clock, ClockSource source, int cached) {
+    if (source == RODEO_CLOCK_TSC) {
+#ifdef CLOCK_HAVE_TSC
+        pthread_once(&tsc_once, calibrate_tsc);
+        if (!tsc.usable) {
+            fprintf(stderr, "Warning: no invariant TSC, using the coarse monotonic clock\n");
+            source = RODEO_CLOCK_COARSE;
+        }
+#else
+        fprintf(stderr, "Warning: TSC clock not available, using the coarse monotonic clock\n");
+        source = RODEO_CLOCK_COARSE;
+#endif
+    }
+
+    clock->source = source;
+    clock->cached = cached;
+    clock->valid = 0;
+    clock->reading = 0;
+}
+
+long rodeo_clock_read_source(ClockSource source) {
+    switch (source) {
+        case RODEO_CLOCK_MONOTONIC:
+            return read_posix(CLOCK_MONOTONIC);
+#ifdef CLOCK_HAVE_TSC
+        case RODEO_CLOCK_TSC:
+            return read_tsc();
+#endif
+        default:
+            return read_posix(CLOCK_MONOTONIC_COARSE);
+    }
+}
+
+int rodeo_clock_parse_source(const char *text, ClockSource *source) {
+    if (strcmp(text, "coarse") == 0) {
+        *source = RODEO_CLOCK_COARSE;
+    } else if (strcmp(text, "monotonic") == 0) {
+        *source = RODEO_CLOCK_MONOTONIC;
+    } else if (strcmp(text, "tsc") == 0) {
+        *source = RODEO_CLOCK_TSC;
+    } else {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+// Monotonic time source for read(time_ms)/read(time_us) and real-time waits.
+// Readings are microseconds on an arbitrary epoch; only differences matter.
+typedef enum {
+    RODEO_CLOCK_COARSE,     // CLOCK_MONOTONIC_COARSE: a few ns per read, tick resolution
+    RODEO_CLOCK_MONOTONIC,  // CLOCK_MONOTONIC: full resolution
+    RODEO_CLOCK_TSC         // calibrated rdtsc on x86-64 with an invariant TSC
+} ClockSource;
+
+typedef struct {
+    ClockSource source;
+    int cached;             // reuse one reading until the next loop iteration or wait
+    int valid;              // `reading` holds the current iteration's time
+    long reading;
+} RodeoClock;
+
+// Falls back to RODEO_CLOCK_COARSE, with a warning, where the TSC is not usable
+void rodeo_clock_init(RodeoClock *clock, ClockSource source, int cached);
+long rodeo_clock_read_source(ClockSource source);
+int rodeo_clock_parse_source(const char *text, ClockSource *source);
+
+static inline long rodeo_clock_now_us(RodeoClock *clock) {
+    if (!clock->cached) return rodeo_clock_read_source(clock->source);
+
+    if (!clock->valid) {
+        clock->reading = rodeo_clock_read_source(clock->source);
+        clock->valid = 1;
+    }
+    return clock->reading;
+}
+
+// Called on every loop iteration and wait, so a cached clock moves on
+static inline void rodeo_clock_invalidate(RodeoClock *clock) {
+    clock->valid = 0;
+}
+
+#endif
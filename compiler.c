@@ -0,0 +1,231 @@
+#include "compiler.h"
+#include <sys/mman.h>
+
+typedef struct {
+    Bytecode *bc;
+    int depth;
+} Compiler;
+
+static void compile_list(Compiler *c, ASTNode *list);
+
+static int emit(Compiler *c, OpCode op, int aux, int arg) {
+    Bytecode *bc = c->bc;
+
+    if (bc->length == bc->capacity) {
+        bc->capacity = bc->capacity ? bc->capacity * 2 : 64;
+        bc->code = (Instruction *)realloc(bc->code, sizeof(Instruction) * bc->capacity);
+    }
+
+    bc->code[bc->length].op = op;
+    bc->code[bc->length].aux = aux;
+    bc->code[bc->length].arg = arg;
+    return bc->length++;
+}
+
+static void push(Compiler *c) {
+    c->depth++;
+    if (c->depth > c->bc->max_stack) {
+        c->bc->max_stack = c->depth;
+    }
+}
+
+static void pop(Compiler *c, int count) {
+    c->depth -= count;
+}
+
+static void patch(Compiler *c, int at) {
+    c->bc->code[at].arg = c->bc->length;
+}
+
+static void compile_expression(Compiler *c, Expression *expr) {
+    if (!expr) {
+        emit(c, BC_PUSH, 0, 0);
+        push(c);
+        return;
+    }
+
+    switch (expr->type) {
+        case EXPR_NUMBER:
+            emit(c, BC_PUSH, 0, expr->data.number);
+            push(c);
+            break;
+
+        case EXPR_IDENTIFIER:
+            emit(c, BC_LOAD, 0, expr->data.identifier.slot);
+            push(c);
+            break;
+
+        case EXPR_BINARY_OP:
+            compile_expression(c, expr->data.binary.left);
+            compile_expression(c, expr->data.binary.right);
+            emit(c, BC_ADD + expr->data.binary.op, 0, 0);
+            pop(c, 1);
+            break;
+    }
+}
+
+static void compile_condition(Compiler *c, Condition *cond) {
+    if (!cond) {
+        emit(c, BC_PUSH, 0, 0);
+        push(c);
+        return;
+    }
+
+    compile_expression(c, cond->left);
+    compile_expression(c, cond->right);
+    emit(c, BC_EQ + cond->op, 0, 0);
+    pop(c, 1);
+}
+
+static void compile_command(Compiler *c, OpCode op, Expression *expr) {
+    compile_expression(c, expr);
+    emit(c, op, 0, 0);
+    pop(c, 1);
+}
+
+static void compile_statement(Compiler *c, ASTNode *stmt) {
+    switch (stmt->type) {
+        case STMT_ASSIGNMENT:
+            compile_expression(c, stmt->data.assignment.expr);
+            emit(c, BC_STORE, 0, stmt->data.assignment.slot);
+            pop(c, 1);
+            break;
+
+        case STMT_IF:
+            {
+                compile_condition(c, stmt->data.if_stmt.condition);
+                int branch = emit(c, BC_BRANCH, 0, 0);
+                pop(c, 1);
+
+                compile_list(c, stmt->data.if_stmt.then_block);
+                if (stmt->data.if_stmt.else_block) {
+                    int skip = emit(c, BC_JUMP, 0, 0);
+                    patch(c, branch);
+                    compile_list(c, stmt->data.if_stmt.else_block);
+                    patch(c, skip);
+                } else {
+                    patch(c, branch);
+                }
+            }
+            break;
+
+        case STMT_WHILE:
+            {
+                int slot = c->bc->loop_count++;
+                emit(c, BC_LOOP_ENTER, 0, slot);
+
+                int top = c->bc->length;
+                compile_condition(c, stmt->data.while_stmt.condition);
+                int exit = emit(c, BC_JUMP_IF_FALSE, 0, 0);
+                pop(c, 1);
+
+                compile_list(c, stmt->data.while_stmt.body);
+                emit(c, BC_LOOP_NEXT, 0, slot);
+                emit(c, BC_JUMP, 0, top);
+
+                patch(c, exit);
+                emit(c, BC_LOOP_EXIT, 0, slot);
+            }
+            break;
+
+        case STMT_SPEED:
+            compile_command(c, BC_SPEED, stmt->data.speed_cmd.expr);
+            break;
+
+        case STMT_TORQUE:
+            compile_command(c, BC_TORQUE, stmt->data.torque_cmd.expr);
+            break;
+
+        case STMT_YAW:
+            compile_command(c, BC_YAW, stmt->data.yaw_cmd.expr);
+            break;
+
+        case STMT_BRAKE:
+            compile_command(c, BC_BRAKE, stmt->data.brake_cmd.expr);
+            break;
+
+        case STMT_WAIT:
+            compile_command(c, BC_WAIT, stmt->data.wait_cmd.expr);
+            break;
+
+        case STMT_PATTERN:
+            emit(c, BC_PATTERN, stmt->data.pattern_cmd.pattern, 0);
+            break;
+
+        case STMT_SENSOR_READ:
+            emit(c, BC_READ, stmt->data.sensor_read.sensor, stmt->data.sensor_read.slot);
+            break;
+
+        case STMT_BLOCK:
+            for (int i = 0; i < stmt->data.block.count; i++) {
+                compile_statement(c, stmt->data.block.statements[i]);
+            }
+            break;
+    }
+}
+
+static void compile_list(Compiler *c, ASTNode *list) {
+    for (ASTNode *current = list; current; current = current->next) {
+        compile_statement(c, current);
+    }
+}
+
+Bytecode *compile_program(ASTNode *program, SymbolTable *symbols) {
+    Bytecode *bc = (Bytecode *)calloc(1, sizeof(Bytecode));
+    Compiler c = { bc, 0 };
+
+    bc->name_count = symbols->count;
+    bc->names = (char **)malloc(sizeof(char *) * (symbols->count + 1));
+    for (int i = 0; i < symbols->count; i++) {
+        bc->names[i] = strdup(symbols->names[i]);
+    }
+
+    compile_list(&c, program);
+    emit(&c, BC_HALT, 0, 0);
+    return bc;
+}
+
+// Stack effect of each opcode; BC_READ stores straight into its register.
+int bytecode_stack_effect(OpCode op) {
+    switch (op) {
+        case BC_PUSH:
+        case BC_LOAD:
+            return 1;
+        case BC_JUMP:
+        case BC_LOOP_ENTER:
+        case BC_LOOP_NEXT:
+        case BC_LOOP_EXIT:
+        case BC_PATTERN:
+        case BC_READ:
+        case BC_HALT:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+int bytecode_reads_sensor(const Bytecode *bc, SensorType sensor) {
+    for (int pc = 0; pc < bc->length; pc++) {
+        const Instruction *ins = &bc->code[pc];
+        if ((ins->op == BC_READ || ins->op == BC_READ_BRANCH) && ins->aux == sensor) return 1;
+    }
+    return 0;
+}
+
+void free_bytecode(Bytecode *bc) {
+    if (!bc) return;
+
+    if (bc->mapping) {
+        munmap(bc->mapping, bc->mapping_size);
+        free(bc->names);
+        free(bc);
+        return;
+    }
+
+    for (int i = 0; i < bc->name_count; i++) {
+        free(bc->names[i]);
+    }
+    free(bc->names);
+    free(bc->code);
+    free(bc);
+}
@@ -0,0 +1,67 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "ast.h"
+#include "resolver.h"
+
+typedef enum {
+    BC_PUSH,            // push arg
+    BC_LOAD,            // push register arg
+    BC_STORE,           // pop into register arg
+    BC_ADD,             // arithmetic, same order as BinaryOp
+    BC_SUB,
+    BC_MUL,
+    BC_DIV,
+    BC_EQ,              // comparisons, same order as RelOp
+    BC_NE,
+    BC_GT,
+    BC_LT,
+    BC_GE,
+    BC_LE,
+    BC_JUMP,            // pc = arg
+    BC_JUMP_IF_FALSE,   // pop, pc = arg if zero
+    BC_BRANCH,          // if statement: pop, trace, pc = arg if zero
+    BC_LOOP_ENTER,      // reset iteration counter arg
+    BC_LOOP_NEXT,       // bump counter arg, skip next instruction past the limit
+    BC_LOOP_EXIT,
+    BC_SPEED,
+    BC_TORQUE,
+    BC_YAW,
+    BC_BRAKE,
+    BC_WAIT,
+    BC_PATTERN,         // aux = Pattern
+    BC_READ,            // aux = SensorType, store into register arg
+    BC_HALT,
+    BC_READ_BRANCH,     // superinstructions, see fuse.h
+    BC_BRAKE_SPEED,
+    BC_SPEED_BRAKE,
+    BC_OPCODE_COUNT
+} OpCode;
+
+typedef struct {
+    unsigned short op;
+    unsigned short aux;
+    int arg;
+} Instruction;
+
+typedef struct {
+    Instruction *code;
+    int length;
+    int capacity;
+
+    char **names;       // register slot names, for tracing
+    int name_count;
+
+    int loop_count;     // one iteration counter per while statement
+    int max_stack;
+
+    void *mapping;      // set when code and names live in an mmap'd image
+    size_t mapping_size;
+} Bytecode;
+
+Bytecode *compile_program(ASTNode *program, SymbolTable *symbols);
+int bytecode_stack_effect(OpCode op);
+int bytecode_reads_sensor(const Bytecode *bc, SensorType sensor);
+void free_bytecode(Bytecode *bc);
+
+#endif
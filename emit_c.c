@@ -0,0 +1,270 @@
+#include "emit_c.h"
+
+typedef struct {
+    FILE *out;
+    int loop_count;     // while statements numbered in the compiler's order
+} Emitter;
+
+static const char *sensor_enum[] = {
+    "SENSOR_RIDER", "SENSOR_TILT", "SENSOR_RPM", "SENSOR_EMERGENCY", "SENSOR_TIME_MS",
+    "SENSOR_TIME_US"
+};
+static const char *pattern_enum[] = {"PATTERN_CALM", "PATTERN_SWIRL", "PATTERN_AGGRESSIVE"};
+
+// Arithmetic wraps like the interpreter instead of being undefined at -O2
+static const char *prelude =
+    "static inline int rodeo_add(int a, int b) { return (int)((unsigned)a + (unsigned)b); }\n"
+    "static inline int rodeo_sub(int a, int b) { return (int)((unsigned)a - (unsigned)b); }\n"
+    "static inline int rodeo_mul(int a, int b) { return (int)((unsigned)a * (unsigned)b); }\n"
+    "\n"
+    "static inline int rodeo_div(int a, int b) {\n"
+    "    if (b == 0) {\n"
+    "        fprintf(stderr, \"Error: Division by zero\\n\");\n"
+    "        return 0;\n"
+    "    }\n"
+    "    return a / b;\n"
+    "}\n"
+    "\n"
+    "static inline int rodeo_var(VMContext *ctx, int slot, int value) {\n"
+    "    trace_event(&ctx->trace, EVENT_VAR, 0, slot, value);\n"
+    "    return value;\n"
+    "}\n"
+    "\n"
+    "static inline int rodeo_if(VMContext *ctx, int value) {\n"
+    "    trace_event(&ctx->trace, EVENT_IF, 0, 0, value);\n"
+    "    return value;\n"
+    "}\n"
+    "\n"
+    "static inline int rodeo_read(VMContext *ctx, SensorType sensor, int slot) {\n"
+    "    int value = vm_read_sensor(ctx, sensor);\n"
+    "    trace_event(&ctx->trace, EVENT_SENSOR, sensor, slot, value);\n"
+    "    return value;\n"
+    "}\n"
+    "\n"
+    "static inline void rodeo_wait(VMContext *ctx, int ms) {\n"
+    "    trace_event(&ctx->trace, EVENT_WAIT, 0, 0, ms);\n"
+    "    vm_wait(ctx, ms);\n"
+    "}\n";
+
+static const char *standalone_main =
+    "#ifndef RODEO_NO_MAIN\n"
+    "int main(int argc, char **argv) {\n"
+    "    TraceLevel level = TRACE_OFF;\n"
+    "    if (argc > 1 && (strncmp(argv[1], \"--trace=\", 8) != 0 ||\n"
+    "                     trace_parse_level(argv[1] + 8, &level) != 0)) {\n"
+    "        fprintf(stderr, \"Usage: %s [--trace=off|summary|full]\\n\", argv[0]);\n"
+    "        return 1;\n"
+    "    }\n"
+    "\n"
+    "    VMContext ctx;\n"
+    "    vm_init(&ctx, level);\n"
+    "    rodeo_program(&ctx);\n"
+    "    trace_flush(&ctx.trace);\n"
+    "    if (level == TRACE_SUMMARY) trace_print_summary(&ctx.trace);\n"
+    "    vm_print_state(&ctx);\n"
+    "    vm_cleanup(&ctx);\n"
+    "    return 0;\n"
+    "}\n"
+    "#endif\n";
+
+static void indent(Emitter *e, int depth) {
+    fprintf(e->out, "%*s", depth * 4, "");
+}
+
+static void emit_expression(Emitter *e, Expression *expr) {
+    const char *helper[] = {"rodeo_add", "rodeo_sub", "rodeo_mul", "rodeo_div"};
+
+    if (!expr) {
+        fprintf(e->out, "0");
+        return;
+    }
+
+    switch (expr->type) {
+        case EXPR_NUMBER:
+            fprintf(e->out, "%d", expr->data.number);
+            break;
+        case EXPR_IDENTIFIER:
+            fprintf(e->out, "v_%s", expr->data.identifier.symbol->name);
+            break;
+        case EXPR_BINARY_OP:
+            fprintf(e->out, "%s(", helper[expr->data.binary.op]);
+            emit_expression(e, expr->data.binary.left);
+            fprintf(e->out, ", ");
+            emit_expression(e, expr->data.binary.right);
+            fprintf(e->out, ")");
+            break;
+    }
+}
+
+static void emit_condition(Emitter *e, Condition *cond) {
+    const char *rel_symbol[] = {"==", "!=", ">", "<", ">=", "<="};
+
+    if (!cond) {
+        fprintf(e->out, "0");
+        return;
+    }
+    emit_expression(e, cond->left);
+    fprintf(e->out, " %s ", rel_symbol[cond->op]);
+    emit_expression(e, cond->right);
+}
+
+static void emit_list(Emitter *e, ASTNode *list, int depth);
+
+static void emit_command(Emitter *e, const char *function, Expression *expr, int depth) {
+    indent(e, depth);
+    fprintf(e->out, "%s(ctx, ", function);
+    emit_expression(e, expr);
+    fprintf(e->out, ");\n");
+}
+
+static void emit_statement(Emitter *e, ASTNode *stmt, int depth) {
+    switch (stmt->type) {
+        case STMT_ASSIGNMENT:
+            indent(e, depth);
+            fprintf(e->out, "v_%s = rodeo_var(ctx, %d, ",
+                    stmt->data.assignment.var->name, stmt->data.assignment.slot);
+            emit_expression(e, stmt->data.assignment.expr);
+            fprintf(e->out, ");\n");
+            break;
+
+        case STMT_IF:
+            indent(e, depth);
+            fprintf(e->out, "if (rodeo_if(ctx, ");
+            emit_condition(e, stmt->data.if_stmt.condition);
+            fprintf(e->out, ")) {\n");
+            emit_list(e, stmt->data.if_stmt.then_block, depth + 1);
+            if (stmt->data.if_stmt.else_block) {
+                indent(e, depth);
+                fprintf(e->out, "} else {\n");
+                emit_list(e, stmt->data.if_stmt.else_block, depth + 1);
+            }
+            indent(e, depth);
+            fprintf(e->out, "}\n");
+            break;
+
+        case STMT_WHILE:
+            {
+                // Same iteration guard as BC_LOOP_NEXT
+                int loop = e->loop_count++;
+                indent(e, depth);
+                fprintf(e->out, "trace_event(&ctx->trace, EVENT_LOOP_ENTER, 0, 0, 0);\n");
+                indent(e, depth);
+                fprintf(e->out, "rodeo_clock_invalidate(&ctx->clock);\n");
+                indent(e, depth);
+                fprintf(e->out, "loop_%d = 0;\n", loop);
+                indent(e, depth);
+                fprintf(e->out, "while (");
+                emit_condition(e, stmt->data.while_stmt.condition);
+                fprintf(e->out, ") {\n");
+                emit_list(e, stmt->data.while_stmt.body, depth + 1);
+                indent(e, depth + 1);
+                fprintf(e->out, "rodeo_clock_invalidate(&ctx->clock);\n");
+                indent(e, depth + 1);
+                fprintf(e->out, "if (++loop_%d > 10000) {\n", loop);
+                indent(e, depth + 2);
+                fprintf(e->out, "fprintf(stderr, \"  [WARNING] Loop exceeded 10000 iterations, "
+                                "breaking\\n\");\n");
+                indent(e, depth + 2);
+                fprintf(e->out, "break;\n");
+                indent(e, depth + 1);
+                fprintf(e->out, "}\n");
+                indent(e, depth);
+                fprintf(e->out, "}\n");
+                indent(e, depth);
+                fprintf(e->out, "trace_event(&ctx->trace, EVENT_LOOP_EXIT, 0, 0, loop_%d);\n", loop);
+            }
+            break;
+
+        case STMT_SPEED:
+            emit_command(e, "vm_set_speed", stmt->data.speed_cmd.expr, depth);
+            break;
+
+        case STMT_TORQUE:
+            emit_command(e, "vm_set_torque", stmt->data.torque_cmd.expr, depth);
+            break;
+
+        case STMT_YAW:
+            emit_command(e, "vm_set_yaw", stmt->data.yaw_cmd.expr, depth);
+            break;
+
+        case STMT_BRAKE:
+            emit_command(e, "vm_set_brake", stmt->data.brake_cmd.expr, depth);
+            break;
+
+        case STMT_WAIT:
+            emit_command(e, "rodeo_wait", stmt->data.wait_cmd.expr, depth);
+            break;
+
+        case STMT_PATTERN:
+            indent(e, depth);
+            fprintf(e->out, "vm_set_pattern(ctx, %s);\n",
+                    pattern_enum[stmt->data.pattern_cmd.pattern]);
+            break;
+
+        case STMT_SENSOR_READ:
+            indent(e, depth);
+            fprintf(e->out, "v_%s = rodeo_read(ctx, %s, %d);\n",
+                    stmt->data.sensor_read.var->name,
+                    sensor_enum[stmt->data.sensor_read.sensor],
+                    stmt->data.sensor_read.slot);
+            break;
+
+        case STMT_BLOCK:
+            for (int i = 0; i < stmt->data.block.count; i++) {
+                emit_statement(e, stmt->data.block.statements[i], depth);
+            }
+            break;
+    }
+}
+
+static void emit_list(Emitter *e, ASTNode *list, int depth) {
+    for (ASTNode *node = list; node; node = node->next) {
+        emit_statement(e, node, depth);
+    }
+}
+
+int emit_c_program(FILE *out, ASTNode *program, Bytecode *bc, const char *source_name) {
+    Emitter e = { out, 0 };
+
+    fprintf(out, "// Generated by rodeo-vm --emit-c from %s\n", source_name);
+    fprintf(out, "// Build: cc -O2 -I<rodeo-vm> program.c vm.o jit.o clock.o trace.o compiler.o\n\n");
+    fprintf(out, "#include \"vm.h\"\n\n");
+    fprintf(out, "%s\n", prelude);
+
+    fprintf(out, "static char *rodeo_names[] = {");
+    for (int i = 0; i < bc->name_count; i++) {
+        fprintf(out, "%s\"%s\"", i ? ", " : "", bc->names[i]);
+    }
+    fprintf(out, "%s};\n\n", bc->name_count ? "" : "0");
+
+    fprintf(out, "void rodeo_program(VMContext *ctx) {\n");
+    fprintf(out, "    vm_reserve_registers(ctx, %d);\n", bc->name_count);
+    fprintf(out, "    ctx->names = rodeo_names;\n");
+    fprintf(out, "    ctx->var_count = %d;\n", bc->name_count);
+    fprintf(out, "    ctx->trace.names = rodeo_names;\n");
+    fprintf(out, "    ctx->trace.name_count = %d;\n\n", bc->name_count);
+
+    // Variables live in locals and are copied to the registers at the end
+    for (int i = 0; i < bc->name_count; i++) {
+        fprintf(out, "    int v_%s = 0;\n", bc->names[i]);
+    }
+    for (int i = 0; i < bc->loop_count; i++) {
+        fprintf(out, "    int loop_%d;\n", i);
+    }
+    if (bc->name_count || bc->loop_count) fprintf(out, "\n");
+
+    emit_list(&e, program, 1);
+    fprintf(out, "    vm_flush_actuators(ctx);\n");
+
+    if (bc->name_count) fprintf(out, "\n");
+    for (int i = 0; i < bc->name_count; i++) {
+        fprintf(out, "    ctx->registers[%d] = v_%s;\n", i, bc->names[i]);
+    }
+    fprintf(out, "}\n\n%s", standalone_main);
+
+    if (ferror(out)) {
+        fprintf(stderr, "Error: could not write the generated C source\n");
+        return -1;
+    }
+    return 0;
+}
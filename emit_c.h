@@ -0,0 +1,13 @@
+#ifndef EMIT_C_H
+#define EMIT_C_H
+
+#include <stdio.h>
+#include "ast.h"
+#include "compiler.h"
+
+// Writes a resolved program as a C translation unit built on vm.h: a
+// rodeo_program(VMContext *) function, plus a main() unless RODEO_NO_MAIN is
+// defined. `bc` supplies the register names the program was compiled with.
+int emit_c_program(FILE *out, ASTNode *program, Bytecode *bc, const char *source_name);
+
+#endif
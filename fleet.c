@@ -0,0 +1,255 @@
+#include "fleet.h"
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLEET_X86 1
+#endif
+
+typedef void (*SensorKernel)(Fleet *fleet, const int *active, int begin, int end);
+
+static void *fleet_array(int capacity, size_t size) {
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 32, size * capacity) != 0) return NULL;
+    memset(ptr, 0, size * capacity);
+    return ptr;
+}
+
+void fleet_init(Fleet *fleet, int count) {
+    int capacity = (count + FLEET_LANES - 1) / FLEET_LANES * FLEET_LANES;
+    if (capacity == 0) capacity = FLEET_LANES;
+
+    fleet->count = count;
+    fleet->capacity = capacity;
+    fleet->speed = (int *)fleet_array(capacity, sizeof(int));
+    fleet->torque = (int *)fleet_array(capacity, sizeof(int));
+    fleet->yaw = (int *)fleet_array(capacity, sizeof(int));
+    fleet->brake = (int *)fleet_array(capacity, sizeof(int));
+    fleet->pattern = (int *)fleet_array(capacity, sizeof(int));
+    fleet->rider_present = (int *)fleet_array(capacity, sizeof(int));
+    fleet->tilt_angle = (int *)fleet_array(capacity, sizeof(int));
+    fleet->rpm = (int *)fleet_array(capacity, sizeof(int));
+    fleet->emergency = (int *)fleet_array(capacity, sizeof(int));
+    fleet->sim_time_ms = (long *)fleet_array(capacity, sizeof(long));
+    fleet->seed = (unsigned int *)fleet_array(capacity, sizeof(unsigned int));
+
+    // Same power-on state as vm_init
+    for (int i = 0; i < capacity; i++) {
+        fleet->brake[i] = 1;
+        fleet->pattern[i] = PATTERN_CALM;
+    }
+}
+
+void fleet_free(Fleet *fleet) {
+    free(fleet->speed);
+    free(fleet->torque);
+    free(fleet->yaw);
+    free(fleet->brake);
+    free(fleet->pattern);
+    free(fleet->rider_present);
+    free(fleet->tilt_angle);
+    free(fleet->rpm);
+    free(fleet->emergency);
+    free(fleet->sim_time_ms);
+    free(fleet->seed);
+    memset(fleet, 0, sizeof(Fleet));
+}
+
+void fleet_get_state(Fleet *fleet, int lane, RodeoState *state) {
+    state->speed = fleet->speed[lane];
+    state->torque = fleet->torque[lane];
+    state->yaw = fleet->yaw[lane];
+    state->brake = fleet->brake[lane];
+    state->pattern = (Pattern)fleet->pattern[lane];
+    state->rider_present = fleet->rider_present[lane];
+    state->tilt_angle = fleet->tilt_angle[lane];
+    state->rpm = fleet->rpm[lane];
+    state->emergency = fleet->emergency[lane];
+    state->start_time_us = 0;
+    state->sim_time_ms = fleet->sim_time_ms[lane];
+}
+
+void fleet_set_state(Fleet *fleet, int lane, const RodeoState *state) {
+    fleet->speed[lane] = state->speed;
+    fleet->torque[lane] = state->torque;
+    fleet->yaw[lane] = state->yaw;
+    fleet->brake[lane] = state->brake;
+    fleet->pattern[lane] = state->pattern;
+    fleet->rider_present[lane] = state->rider_present;
+    fleet->tilt_angle[lane] = state->tilt_angle;
+    fleet->rpm[lane] = state->rpm;
+    fleet->emergency[lane] = state->emergency;
+    fleet->sim_time_ms[lane] = state->sim_time_ms;
+}
+
+static void sensors_scalar(Fleet *fleet, const int *active, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        if (active && !active[i]) continue;
+
+        fleet->rider_present[i] = 1;
+
+        int tilt = (int)((unsigned int)fleet->speed[i] * (unsigned int)fleet->yaw[i]) / 10;
+        unsigned int seed = fleet->seed[i];
+        if (seed) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            fleet->seed[i] = seed;
+            tilt += (int)(seed % 7) - 3;
+        }
+        fleet->tilt_angle[i] = tilt > 45 ? 45 : tilt;
+
+        fleet->rpm[i] = fleet->speed[i] * 10;
+    }
+}
+
+#ifdef FLEET_X86
+
+// Signed division by 10 and unsigned remainder by 7 use the usual
+// multiply-high reciprocals; there is no vector integer divide.
+#define DIV10_MAGIC 0x66666667
+#define DIV7_MAGIC 0x24924925
+
+__attribute__((target("sse4.1")))
+static inline __m128i mulhi_epi32_sse(__m128i a, __m128i magic) {
+    __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, magic), 32);
+    __m128i odd = _mm_mul_epi32(_mm_srli_epi64(a, 32), magic);
+    return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i mulhi_epu32_sse(__m128i a, __m128i magic) {
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(a, magic), 32);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), magic);
+    return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+__attribute__((target("sse4.1")))
+static void sensors_sse41(Fleet *fleet, const int *active, int begin, int end) {
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i three = _mm_set1_epi32(3);
+    const __m128i seven = _mm_set1_epi32(7);
+    const __m128i ten = _mm_set1_epi32(10);
+    const __m128i max_tilt = _mm_set1_epi32(45);
+    const __m128i div10 = _mm_set1_epi32(DIV10_MAGIC);
+    const __m128i div7 = _mm_set1_epi32(DIV7_MAGIC);
+
+    for (int i = begin; i < end; i += 4) {
+        __m128i mask = active ? _mm_load_si128((const __m128i *)(active + i)) : _mm_set1_epi32(-1);
+        __m128i speed = _mm_load_si128((const __m128i *)(fleet->speed + i));
+        __m128i yaw = _mm_load_si128((const __m128i *)(fleet->yaw + i));
+        __m128i seed = _mm_load_si128((const __m128i *)(fleet->seed + i));
+
+        __m128i product = _mm_mullo_epi32(speed, yaw);
+        __m128i tilt = _mm_add_epi32(_mm_srai_epi32(mulhi_epi32_sse(product, div10), 2),
+                                     _mm_srli_epi32(product, 31));
+
+        __m128i seeded = _mm_andnot_si128(_mm_cmpeq_epi32(seed, _mm_setzero_si128()), mask);
+        __m128i next = _mm_xor_si128(seed, _mm_slli_epi32(seed, 13));
+        next = _mm_xor_si128(next, _mm_srli_epi32(next, 17));
+        next = _mm_xor_si128(next, _mm_slli_epi32(next, 5));
+        __m128i q = mulhi_epu32_sse(next, div7);
+        q = _mm_srli_epi32(_mm_add_epi32(_mm_srli_epi32(_mm_sub_epi32(next, q), 1), q), 2);
+        __m128i noise = _mm_sub_epi32(_mm_sub_epi32(next, _mm_mullo_epi32(q, seven)), three);
+        tilt = _mm_add_epi32(tilt, _mm_and_si128(noise, seeded));
+        tilt = _mm_min_epi32(tilt, max_tilt);
+
+        __m128i rpm = _mm_mullo_epi32(speed, ten);
+
+        _mm_store_si128((__m128i *)(fleet->seed + i), _mm_blendv_epi8(seed, next, seeded));
+        _mm_store_si128((__m128i *)(fleet->tilt_angle + i),
+                        _mm_blendv_epi8(_mm_load_si128((const __m128i *)(fleet->tilt_angle + i)), tilt, mask));
+        _mm_store_si128((__m128i *)(fleet->rpm + i),
+                        _mm_blendv_epi8(_mm_load_si128((const __m128i *)(fleet->rpm + i)), rpm, mask));
+        _mm_store_si128((__m128i *)(fleet->rider_present + i),
+                        _mm_blendv_epi8(_mm_load_si128((const __m128i *)(fleet->rider_present + i)), one, mask));
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i mulhi_epi32_avx2(__m256i a, __m256i magic) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, magic), 32);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), magic);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i mulhi_epu32_avx2(__m256i a, __m256i magic) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, magic), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), magic);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+__attribute__((target("avx2")))
+static void sensors_avx2(Fleet *fleet, const int *active, int begin, int end) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i seven = _mm256_set1_epi32(7);
+    const __m256i ten = _mm256_set1_epi32(10);
+    const __m256i max_tilt = _mm256_set1_epi32(45);
+    const __m256i div10 = _mm256_set1_epi32(DIV10_MAGIC);
+    const __m256i div7 = _mm256_set1_epi32(DIV7_MAGIC);
+
+    for (int i = begin; i < end; i += 8) {
+        __m256i mask = active ? _mm256_load_si256((const __m256i *)(active + i)) : _mm256_set1_epi32(-1);
+        __m256i speed = _mm256_load_si256((const __m256i *)(fleet->speed + i));
+        __m256i yaw = _mm256_load_si256((const __m256i *)(fleet->yaw + i));
+        __m256i seed = _mm256_load_si256((const __m256i *)(fleet->seed + i));
+
+        __m256i product = _mm256_mullo_epi32(speed, yaw);
+        __m256i tilt = _mm256_add_epi32(_mm256_srai_epi32(mulhi_epi32_avx2(product, div10), 2),
+                                        _mm256_srli_epi32(product, 31));
+
+        __m256i seeded = _mm256_andnot_si256(_mm256_cmpeq_epi32(seed, _mm256_setzero_si256()), mask);
+        __m256i next = _mm256_xor_si256(seed, _mm256_slli_epi32(seed, 13));
+        next = _mm256_xor_si256(next, _mm256_srli_epi32(next, 17));
+        next = _mm256_xor_si256(next, _mm256_slli_epi32(next, 5));
+        __m256i q = mulhi_epu32_avx2(next, div7);
+        q = _mm256_srli_epi32(_mm256_add_epi32(_mm256_srli_epi32(_mm256_sub_epi32(next, q), 1), q), 2);
+        __m256i noise = _mm256_sub_epi32(_mm256_sub_epi32(next, _mm256_mullo_epi32(q, seven)), three);
+        tilt = _mm256_add_epi32(tilt, _mm256_and_si256(noise, seeded));
+        tilt = _mm256_min_epi32(tilt, max_tilt);
+
+        __m256i rpm = _mm256_mullo_epi32(speed, ten);
+
+        _mm256_store_si256((__m256i *)(fleet->seed + i), _mm256_blendv_epi8(seed, next, seeded));
+        _mm256_store_si256((__m256i *)(fleet->tilt_angle + i),
+                           _mm256_blendv_epi8(_mm256_load_si256((const __m256i *)(fleet->tilt_angle + i)), tilt, mask));
+        _mm256_store_si256((__m256i *)(fleet->rpm + i),
+                           _mm256_blendv_epi8(_mm256_load_si256((const __m256i *)(fleet->rpm + i)), rpm, mask));
+        _mm256_store_si256((__m256i *)(fleet->rider_present + i),
+                           _mm256_blendv_epi8(_mm256_load_si256((const __m256i *)(fleet->rider_present + i)), one, mask));
+    }
+}
+
+#endif
+
+static SensorKernel sensor_kernel;
+static const char *sensor_kernel_name;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+static void select_kernel(void) {
+    sensor_kernel = sensors_scalar;
+    sensor_kernel_name = "scalar";
+#ifdef FLEET_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        sensor_kernel = sensors_avx2;
+        sensor_kernel_name = "avx2";
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        sensor_kernel = sensors_sse41;
+        sensor_kernel_name = "sse4.1";
+    }
+#endif
+}
+
+void fleet_simulate_sensors(Fleet *fleet, const int *active) {
+    pthread_once(&kernel_once, select_kernel);
+    // capacity is a multiple of FLEET_LANES and the padding lanes are never read back
+    sensor_kernel(fleet, active, 0, fleet->capacity);
+}
+
+const char *fleet_kernel_name(void) {
+    pthread_once(&kernel_once, select_kernel);
+    return sensor_kernel_name;
+}
@@ -0,0 +1,41 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "vm.h"
+
+#define FLEET_LANES 8       // arrays are padded to a whole AVX2 vector
+
+// RodeoState of many machines, one contiguous array per field, so the sensor
+// model can update whole vectors of machines at once.
+typedef struct {
+    int count;
+    int capacity;           // count rounded up to FLEET_LANES
+
+    int *speed;
+    int *torque;
+    int *yaw;
+    int *brake;
+    int *pattern;
+
+    int *rider_present;
+    int *tilt_angle;
+    int *rpm;
+    int *emergency;
+    long *sim_time_ms;
+
+    unsigned int *seed;     // per machine; non-zero adds sensor noise
+} Fleet;
+
+void fleet_init(Fleet *fleet, int count);
+void fleet_free(Fleet *fleet);
+
+void fleet_get_state(Fleet *fleet, int lane, RodeoState *state);
+void fleet_set_state(Fleet *fleet, int lane, const RodeoState *state);
+
+// Same model as vm_simulate_sensors. `active` holds -1 for machines to update
+// and 0 for machines to leave alone; NULL updates all of them.
+void fleet_simulate_sensors(Fleet *fleet, const int *active);
+
+const char *fleet_kernel_name(void);
+
+#endif
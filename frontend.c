@@ -0,0 +1,256 @@
+#include "frontend.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "resolver.h"
+#include "optimizer.h"
+#include "fuse.h"
+#include "parser.tab.h"
+#include "scanner.h"
+
+// Flex does not write a header for the reentrant scanner, so the parts of its
+// interface used here are declared by hand.
+typedef void *yyscan_t;
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+
+int yylex_init_extra(RodeoProgram *extra, yyscan_t *scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE *in, yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_bytes(const char *bytes, size_t length, yyscan_t scanner);
+int yylex(YYSTYPE *lvalp, yyscan_t scanner);
+
+// What the parser's scanner argument points to; rodeo_lex picks the scanner.
+typedef struct {
+    ScannerKind kind;
+    yyscan_t flex;
+    Scanner fast;
+} Lexer;
+
+int rodeo_lex(YYSTYPE *lvalp, void *data) {
+    Lexer *lexer = (Lexer *)data;
+    if (lexer->kind == SCANNER_FAST) {
+        return scanner_lex(&lexer->fast, lvalp);
+    }
+    return yylex(lvalp, lexer->flex);
+}
+
+static RodeoProgram *create_program(void) {
+    RodeoProgram *program = (RodeoProgram *)calloc(1, sizeof(RodeoProgram));
+    arena_init(&program->arena);
+    interner_init(&program->identifiers, &program->arena);
+    program->line_num = 1;
+    return program;
+}
+
+void rodeo_add_diagnostic(RodeoProgram *program, DiagnosticKind kind, const char *format, ...) {
+    if (program->diagnostic_count == program->diagnostic_capacity) {
+        program->diagnostic_capacity = program->diagnostic_capacity ? program->diagnostic_capacity * 2 : 4;
+        program->diagnostics = (Diagnostic *)realloc(program->diagnostics,
+                                                     sizeof(Diagnostic) * program->diagnostic_capacity);
+    }
+
+    Diagnostic *diag = &program->diagnostics[program->diagnostic_count++];
+    diag->kind = kind;
+    diag->line = program->line_num;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(diag->message, sizeof(diag->message), format, args);
+    va_end(args);
+}
+
+void rodeo_print_diagnostics(FILE *out, RodeoProgram *program) {
+    for (int i = 0; i < program->diagnostic_count; i++) {
+        Diagnostic *diag = &program->diagnostics[i];
+        switch (diag->kind) {
+            case DIAG_IO:
+                fprintf(out, "%s\n", diag->message);
+                break;
+            case DIAG_LEXICAL:
+                fprintf(out, "Lexical error at line %d: %s\n", diag->line, diag->message);
+                break;
+            case DIAG_SYNTAX:
+                fprintf(out, "Syntax error at line %d: %s\n", diag->line, diag->message);
+                break;
+        }
+    }
+}
+
+// A NULL source scans `file` with Flex; the fast scanner only reads buffers
+static int open_lexer(Lexer *lexer, RodeoProgram *program, ScannerKind kind, FILE *file,
+                      const char *source, size_t length) {
+    lexer->kind = kind;
+    if (kind == SCANNER_FAST) {
+        scanner_init(&lexer->fast, program, source, length);
+        return 0;
+    }
+
+    if (yylex_init_extra(program, &lexer->flex) != 0) {
+        rodeo_add_diagnostic(program, DIAG_IO, "Error: cannot create scanner: %s", strerror(errno));
+        program->failed = 1;
+        return -1;
+    }
+    if (source) {
+        yy_scan_bytes(source, length, lexer->flex);
+    } else {
+        yyset_in(file, lexer->flex);
+    }
+    return 0;
+}
+
+static void close_lexer(Lexer *lexer) {
+    if (lexer->kind == SCANNER_FLEX) {
+        yylex_destroy(lexer->flex);
+    }
+}
+
+static void parse(RodeoProgram *program, ScannerKind kind, FILE *file, const char *source,
+                  size_t length) {
+    Lexer lexer;
+    if (open_lexer(&lexer, program, kind, file, source, length) != 0) return;
+
+    if (yyparse(program, &lexer) != 0) {
+        program->failed = 1;
+    }
+    close_lexer(&lexer);
+}
+
+// Reads the rest of the stream into memory for the fast scanner
+static char *read_stream(FILE *file, size_t *length) {
+    size_t capacity = 4096;
+    char *data = (char *)malloc(capacity);
+    *length = 0;
+
+    size_t n;
+    while ((n = fread(data + *length, 1, capacity - *length, file)) > 0) {
+        *length += n;
+        if (*length == capacity) {
+            capacity *= 2;
+            data = (char *)realloc(data, capacity);
+        }
+    }
+    if (ferror(file)) {
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+RodeoProgram *rodeo_parse_stream(FILE *file, ScannerKind scanner) {
+    RodeoProgram *program = create_program();
+    if (scanner == SCANNER_FLEX) {
+        parse(program, SCANNER_FLEX, file, NULL, 0);
+        return program;
+    }
+
+    size_t length;
+    char *source = read_stream(file, &length);
+    if (!source) {
+        rodeo_add_diagnostic(program, DIAG_IO, "Error: cannot read input: %s", strerror(errno));
+        program->failed = 1;
+        return program;
+    }
+    parse(program, SCANNER_FAST, NULL, source, length);
+    free(source);
+    return program;
+}
+
+static RodeoProgram *parse_mapped(const char *path) {
+    RodeoProgram *program = create_program();
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        rodeo_add_diagnostic(program, DIAG_IO, "%s: %s", path, strerror(errno));
+        program->failed = 1;
+        if (fd >= 0) close(fd);
+        return program;
+    }
+
+    // Identifiers are interned straight from the mapping, so it is only needed
+    // while parsing. mmap rejects empty files, which have nothing to scan.
+    size_t length = (size_t)info.st_size;
+    if (length == 0) {
+        parse(program, SCANNER_FAST, NULL, "", 0);
+        close(fd);
+        return program;
+    }
+
+    void *source = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (source == MAP_FAILED) {
+        rodeo_add_diagnostic(program, DIAG_IO, "%s: %s", path, strerror(errno));
+        program->failed = 1;
+        return program;
+    }
+    madvise(source, length, MADV_SEQUENTIAL);
+
+    parse(program, SCANNER_FAST, NULL, (const char *)source, length);
+    munmap(source, length);
+    return program;
+}
+
+RodeoProgram *rodeo_parse_file(const char *path, ScannerKind scanner) {
+    if (scanner == SCANNER_FAST) {
+        return parse_mapped(path);
+    }
+
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        RodeoProgram *program = create_program();
+        rodeo_add_diagnostic(program, DIAG_IO, "%s: %s", path, strerror(errno));
+        program->failed = 1;
+        return program;
+    }
+
+    RodeoProgram *program = rodeo_parse_stream(file, SCANNER_FLEX);
+    fclose(file);
+    return program;
+}
+
+RodeoProgram *rodeo_parse_buffer(const char *source, size_t length, ScannerKind scanner) {
+    RodeoProgram *program = create_program();
+    parse(program, scanner, NULL, source, length);
+    return program;
+}
+
+long rodeo_scan_buffer(const char *source, size_t length, ScannerKind scanner) {
+    RodeoProgram *program = create_program();
+    Lexer lexer;
+    long tokens = 0;
+    if (open_lexer(&lexer, program, scanner, NULL, source, length) == 0) {
+        YYSTYPE value;
+        while (rodeo_lex(&value, &lexer) != 0) {
+            tokens++;
+        }
+        close_lexer(&lexer);
+    }
+    rodeo_free_program(program);
+    return tokens;
+}
+
+void rodeo_free_program(RodeoProgram *program) {
+    if (!program) return;
+    interner_free(&program->identifiers);
+    arena_release(&program->arena);
+    free(program->diagnostics);
+    free(program);
+}
+
+Bytecode *rodeo_compile(RodeoProgram *program, int optimize, unsigned int fuse) {
+    SymbolTable symbols;
+    if (resolve_program(program->statements, &symbols) != 0) {
+        free_symbols(&symbols);
+        return NULL;
+    }
+
+    if (optimize) {
+        optimize_program(program->statements, &symbols);
+    }
+    Bytecode *code = compile_program(program->statements, &symbols);
+    fuse_program(code, fuse);
+    free_symbols(&symbols);
+    return code;
+}
@@ -0,0 +1,60 @@
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include <stdio.h>
+#include "arena.h"
+#include "ast.h"
+#include "intern.h"
+#include "compiler.h"
+
+#define DIAGNOSTIC_MESSAGE_SIZE 128
+
+typedef enum {
+    DIAG_IO,
+    DIAG_LEXICAL,
+    DIAG_SYNTAX
+} DiagnosticKind;
+
+typedef struct {
+    DiagnosticKind kind;
+    int line;
+    char message[DIAGNOSTIC_MESSAGE_SIZE];
+} Diagnostic;
+
+// One parsed program. Owns its AST arena and diagnostics, and shares no state
+// with other programs, so several can be parsed at once on different threads.
+typedef struct {
+    Arena arena;
+    Interner identifiers;   // every identifier of the program, interned while scanning
+    ASTNode *statements;
+
+    Diagnostic *diagnostics;
+    int diagnostic_count;
+    int diagnostic_capacity;
+
+    int line_num;       // current line while scanning
+    int failed;         // the parser gave up; statements is not usable
+} RodeoProgram;
+
+typedef enum {
+    SCANNER_FLEX,       // generated from lexer.l
+    SCANNER_FAST        // hand-written, see scanner.c
+} ScannerKind;
+
+// With SCANNER_FAST a file is mmap'd and a stream is read whole before scanning
+RodeoProgram *rodeo_parse_file(const char *path, ScannerKind scanner);
+RodeoProgram *rodeo_parse_stream(FILE *file, ScannerKind scanner);
+RodeoProgram *rodeo_parse_buffer(const char *source, size_t length, ScannerKind scanner);
+
+// Tokenizes without parsing and returns the number of tokens; for benchmarks
+long rodeo_scan_buffer(const char *source, size_t length, ScannerKind scanner);
+void rodeo_free_program(RodeoProgram *program);
+
+// Resolves, optimizes and compiles the program, then fuses the superinstructions
+// in `fuse` (a FuseSet mask). The AST is left in place.
+Bytecode *rodeo_compile(RodeoProgram *program, int optimize, unsigned int fuse);
+
+void rodeo_add_diagnostic(RodeoProgram *program, DiagnosticKind kind, const char *format, ...);
+void rodeo_print_diagnostics(FILE *out, RodeoProgram *program);
+
+#endif
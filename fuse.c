@@ -0,0 +1,136 @@
+#include "fuse.h"
+#include <stdlib.h>
+
+typedef struct {
+    OpCode op;
+    FuseSet set;
+    TraceEventType first;       // the statement pair it covers in a trace
+    TraceEventType second;
+    const char *name;
+} Superinstruction;
+
+static const Superinstruction superinstructions[] = {
+    { BC_READ_BRANCH, FUSE_READ_BRANCH, EVENT_SENSOR, EVENT_IF, "read_branch" },
+    { BC_BRAKE_SPEED, FUSE_BRAKE_SPEED, EVENT_BRAKE, EVENT_SPEED, "brake_speed" },
+    { BC_SPEED_BRAKE, FUSE_SPEED_BRAKE, EVENT_SPEED, EVENT_BRAKE, "speed_brake" },
+};
+
+#define SUPERINSTRUCTION_COUNT (int)(sizeof(superinstructions) / sizeof(superinstructions[0]))
+
+static int is_relop(OpCode op) {
+    return op >= BC_EQ && op <= BC_LE;
+}
+
+// Matches against the original opcodes, since a sequence may start inside
+// another one that was fused first.
+static int matches(const Instruction *code, int length, int pc, OpCode op) {
+    const Instruction *ins = &code[pc];
+
+    switch (op) {
+        case BC_READ_BRANCH:
+            // READ s -> r; LOAD r; PUSH k; REL; BRANCH
+            return pc + 4 < length &&
+                   fuse_original(&ins[0]) == BC_READ &&
+                   fuse_original(&ins[1]) == BC_LOAD && ins[1].arg == ins[0].arg &&
+                   fuse_original(&ins[2]) == BC_PUSH &&
+                   is_relop(fuse_original(&ins[3])) &&
+                   fuse_original(&ins[4]) == BC_BRANCH;
+
+        case BC_BRAKE_SPEED:
+            // PUSH b; BRAKE; PUSH s; SPEED
+            return pc + 3 < length &&
+                   fuse_original(&ins[0]) == BC_PUSH && fuse_original(&ins[1]) == BC_BRAKE &&
+                   fuse_original(&ins[2]) == BC_PUSH && fuse_original(&ins[3]) == BC_SPEED;
+
+        case BC_SPEED_BRAKE:
+            // PUSH s; SPEED; PUSH b; BRAKE
+            return pc + 3 < length &&
+                   fuse_original(&ins[0]) == BC_PUSH && fuse_original(&ins[1]) == BC_SPEED &&
+                   fuse_original(&ins[2]) == BC_PUSH && fuse_original(&ins[3]) == BC_BRAKE;
+
+        default:
+            return 0;
+    }
+}
+
+void fuse_program(Bytecode *bc, unsigned int set) {
+    for (int pc = 0; pc < bc->length; pc++) {
+        for (int i = 0; i < SUPERINSTRUCTION_COUNT; i++) {
+            const Superinstruction *s = &superinstructions[i];
+            if ((set & s->set) && matches(bc->code, bc->length, pc, s->op)) {
+                bc->code[pc].op = s->op;
+                break;
+            }
+        }
+    }
+}
+
+int fuse_check(const Instruction *code, int length, int pc) {
+    return matches(code, length, pc, (OpCode)code[pc].op);
+}
+
+static void count_pair(void *data, const TraceEvent *event) {
+    PairProfile *profile = (PairProfile *)data;
+
+    // Loop bookkeeping events are not statements and would split real pairs
+    if (event->type == EVENT_LOOP_ENTER || event->type == EVENT_LOOP_EXIT) return;
+
+    if (profile->last >= 0) {
+        profile->counts[profile->last][event->type]++;
+        profile->total++;
+    }
+    profile->last = event->type;
+}
+
+int fuse_mine_trace(const char *path, PairProfile *profile) {
+    memset(profile, 0, sizeof(PairProfile));
+    profile->last = -1;
+    return trace_read_file(path, count_pair, profile);
+}
+
+static const char *covering(int first, int second) {
+    for (int i = 0; i < SUPERINSTRUCTION_COUNT; i++) {
+        if (superinstructions[i].first == first && superinstructions[i].second == second) {
+            return superinstructions[i].name;
+        }
+    }
+    return "-";
+}
+
+void fuse_print_pairs(FILE *out, PairProfile *profile, int top) {
+    fprintf(out, "  [FUSE] %ld statement pairs\n", profile->total);
+
+    // Repeatedly pick the largest remaining pair; the table is tiny
+    char taken[EVENT_COUNT][EVENT_COUNT] = {{0}};
+    for (int n = 0; n < top; n++) {
+        int best_first = -1, best_second = -1;
+        long best = 0;
+        for (int a = 0; a < EVENT_COUNT; a++) {
+            for (int b = 0; b < EVENT_COUNT; b++) {
+                if (!taken[a][b] && profile->counts[a][b] > best) {
+                    best = profile->counts[a][b];
+                    best_first = a;
+                    best_second = b;
+                }
+            }
+        }
+        if (best_first < 0) break;
+
+        taken[best_first][best_second] = 1;
+        fprintf(out, "  [FUSE] %-8s -> %-8s %8ld %5.1f%%  %s\n",
+                trace_event_name(best_first), trace_event_name(best_second),
+                best, 100.0 * best / profile->total, covering(best_first, best_second));
+    }
+}
+
+unsigned int fuse_select(PairProfile *profile) {
+    unsigned int set = 0;
+    for (int i = 0; i < SUPERINSTRUCTION_COUNT; i++) {
+        const Superinstruction *s = &superinstructions[i];
+        long count = profile->counts[s->first][s->second];
+        if (count > 0 && count * 100 >= profile->total * FUSE_MIN_PERCENT) {
+            set |= s->set;
+        }
+    }
+    return set;
+}
@@ -0,0 +1,49 @@
+#ifndef FUSE_H
+#define FUSE_H
+
+#include <stdio.h>
+#include "compiler.h"
+#include "trace.h"
+
+// Superinstructions. A fused instruction replaces only the opcode of the first
+// instruction of its sequence and reads its operands from the ones after it,
+// which stay in place, so jumps into the middle of a sequence still work.
+typedef enum {
+    FUSE_READ_BRANCH = 1 << 0,  // read(s) -> v; if (v REL k)
+    FUSE_BRAKE_SPEED = 1 << 1,  // brake(k); speed(k)
+    FUSE_SPEED_BRAKE = 1 << 2,  // speed(k); brake(k)
+    FUSE_ALL = 0x7
+} FuseSet;
+
+#define FUSE_MIN_PERCENT 1  // share of the mined pairs a superinstruction must cover
+
+typedef struct {
+    long counts[EVENT_COUNT][EVENT_COUNT];  // [first][second] statement event pairs
+    long total;
+    int last;                               // previous event while mining
+} PairProfile;
+
+void fuse_program(Bytecode *bc, unsigned int set);
+
+// Nonzero if the instructions after pc have the shape the fused opcode at pc expects.
+int fuse_check(const Instruction *code, int length, int pc);
+
+// Counts adjacent statement pairs in a binary trace written with --trace-file.
+int fuse_mine_trace(const char *path, PairProfile *profile);
+void fuse_print_pairs(FILE *out, PairProfile *profile, int top);
+unsigned int fuse_select(PairProfile *profile);
+
+// The instruction a fused head stands for when its sequence is not taken whole.
+static inline OpCode fuse_original(const Instruction *ins) {
+    switch (ins->op) {
+        case BC_READ_BRANCH:
+            return BC_READ;
+        case BC_BRAKE_SPEED:
+        case BC_SPEED_BRAKE:
+            return BC_PUSH;
+        default:
+            return (OpCode)ins->op;
+    }
+}
+
+#endif
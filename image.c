@@ -0,0 +1,260 @@
+#include "image.h"
+#include "fuse.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int image_write(const char *path, Bytecode *bc) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+
+    ImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IMAGE_MAGIC, 4);
+    header.version = IMAGE_VERSION;
+    header.instruction_size = sizeof(Instruction);
+    header.length = bc->length;
+    header.name_count = bc->name_count;
+    header.loop_count = bc->loop_count;
+    header.max_stack = bc->max_stack;
+    for (int i = 0; i < bc->name_count; i++) {
+        header.strings_size += strlen(bc->names[i]) + 1;
+    }
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(bc->code, sizeof(Instruction), bc->length, file);
+    for (int i = 0; i < bc->name_count; i++) {
+        fwrite(bc->names[i], 1, strlen(bc->names[i]) + 1, file);
+    }
+
+    if (ferror(file) | fclose(file)) {
+        fprintf(stderr, "Error: failed to write %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+int image_probe(const char *path) {
+    char magic[4];
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+
+    int found = fread(magic, 1, 4, file) == 4 && memcmp(magic, IMAGE_MAGIC, 4) == 0;
+    fclose(file);
+    return found;
+}
+
+// Operands an instruction pops before pushing its result
+static int stack_inputs(OpCode op) {
+    switch (op) {
+        case BC_ADD: case BC_SUB: case BC_MUL: case BC_DIV:
+        case BC_EQ: case BC_NE: case BC_GT: case BC_LT: case BC_GE: case BC_LE:
+            return 2;
+        case BC_STORE:
+        case BC_JUMP_IF_FALSE:
+        case BC_BRANCH:
+        case BC_SPEED: case BC_TORQUE: case BC_YAW: case BC_BRAKE: case BC_WAIT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Follows every path through the code from pc 0, recording the stack depth on
+// entry to each instruction. Paths that meet must agree on it, and no
+// instruction may pop more than is there or push past max_stack. Fused heads
+// run the instructions after them in order, so checking those at their
+// original opcodes covers the fused path too. *deepest is the largest depth
+// any path reaches.
+static int verify_stack(Instruction *code, int length, int max_stack, int *deepest) {
+    int *depths = (int *)malloc(sizeof(int) * length);
+    int *pending = (int *)malloc(sizeof(int) * length);
+    int pending_count = 0;
+    int status = 0;
+
+    for (int pc = 0; pc < length; pc++) {
+        depths[pc] = -1;
+    }
+    depths[0] = 0;
+    pending[pending_count++] = 0;
+    *deepest = 0;
+
+    while (pending_count > 0 && status == 0) {
+        int pc = pending[--pending_count];
+        OpCode op = fuse_original(&code[pc]);
+        int depth = depths[pc];
+        if (depth < stack_inputs(op)) {
+            status = -1;
+            break;
+        }
+        depth += bytecode_stack_effect(op);
+        if (depth > max_stack) {
+            status = -1;
+            break;
+        }
+        if (depth > *deepest) *deepest = depth;
+
+        int next[2];
+        int next_count = 0;
+        switch (op) {
+            case BC_HALT:
+                break;
+            case BC_JUMP:
+                next[next_count++] = code[pc].arg;
+                break;
+            case BC_JUMP_IF_FALSE:
+            case BC_BRANCH:
+                next[next_count++] = pc + 1;
+                next[next_count++] = code[pc].arg;
+                break;
+            case BC_LOOP_NEXT:
+                // Past the iteration limit it skips the jump back
+                next[next_count++] = pc + 1;
+                next[next_count++] = pc + 2;
+                break;
+            default:
+                next[next_count++] = pc + 1;
+                break;
+        }
+
+        for (int i = 0; i < next_count; i++) {
+            int target = next[i];
+            if (target >= length || (depths[target] >= 0 && depths[target] != depth)) {
+                status = -1;
+                break;
+            }
+            if (depths[target] < 0) {
+                depths[target] = depth;
+                pending[pending_count++] = target;
+            }
+        }
+    }
+
+    free(depths);
+    free(pending);
+    return status;
+}
+
+// The VM trusts its bytecode, so reject anything the compiler could not have
+// produced: unknown opcodes, out of range operands, or a stack that could
+// underflow or overflow on some path. The VM sizes its stack and loop
+// counters from the header, so those must also match the code.
+static int verify(Instruction *code, int length, ImageHeader *header) {
+    if (length == 0 || code[length - 1].op != BC_HALT) return -1;
+
+    int loop_enters = 0;
+
+    for (int pc = 0; pc < length; pc++) {
+        Instruction *ins = &code[pc];
+        if (ins->op >= BC_OPCODE_COUNT) return -1;
+        if (fuse_original(ins) != ins->op && !fuse_check(code, length, pc)) return -1;
+
+        switch (fuse_original(ins)) {
+            case BC_LOAD:
+            case BC_STORE:
+                if (ins->arg < 0 || ins->arg >= header->name_count) return -1;
+                break;
+            case BC_READ:
+                if (ins->arg < 0 || ins->arg >= header->name_count) return -1;
+                if (ins->aux > SENSOR_TIME_US) return -1;
+                break;
+            case BC_JUMP:
+            case BC_JUMP_IF_FALSE:
+            case BC_BRANCH:
+                if (ins->arg < 0 || ins->arg >= length) return -1;
+                break;
+            case BC_LOOP_ENTER:
+                loop_enters++;
+                if (ins->arg < 0 || ins->arg >= header->loop_count) return -1;
+                break;
+            case BC_LOOP_NEXT:
+            case BC_LOOP_EXIT:
+                if (ins->arg < 0 || ins->arg >= header->loop_count) return -1;
+                break;
+            case BC_PATTERN:
+                if (ins->aux > PATTERN_AGGRESSIVE) return -1;
+                break;
+            default:
+                break;
+        }
+
+    }
+    // Every while statement has one LOOP_ENTER and its own counter
+    if (header->loop_count > loop_enters) return -1;
+
+    int deepest;
+    if (verify_stack(code, length, header->max_stack, &deepest) != 0) return -1;
+    return header->max_stack > deepest ? -1 : 0;
+}
+
+Bytecode *image_load(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ImageHeader)) {
+        fprintf(stderr, "Error: %s is not a program image\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    char *base = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+
+    ImageHeader *header = (ImageHeader *)base;
+    size_t code_size = (size_t)header->length * sizeof(Instruction);
+    if (memcmp(header->magic, IMAGE_MAGIC, 4) != 0 ||
+        header->version != IMAGE_VERSION ||
+        header->instruction_size != (int)sizeof(Instruction) ||
+        header->length <= 0 || header->name_count < 0 || header->name_count > MAX_VARIABLES ||
+        header->loop_count < 0 || header->max_stack < 0 || header->strings_size < 0 ||
+        sizeof(ImageHeader) + code_size + header->strings_size != size) {
+        fprintf(stderr, "Error: %s: unsupported or corrupt program image\n", path);
+        munmap(base, size);
+        return NULL;
+    }
+
+    Bytecode *bc = (Bytecode *)calloc(1, sizeof(Bytecode));
+    bc->code = (Instruction *)(base + sizeof(ImageHeader));
+    bc->length = header->length;
+    bc->capacity = header->length;
+    bc->name_count = header->name_count;
+    bc->loop_count = header->loop_count;
+    bc->max_stack = header->max_stack;
+    bc->mapping = base;
+    bc->mapping_size = size;
+    bc->names = (char **)malloc(sizeof(char *) * (header->name_count + 1));
+
+    char *strings = base + sizeof(ImageHeader) + code_size;
+    char *end = strings + header->strings_size;
+    char *name = strings;
+    int valid = 1;
+    for (int i = 0; i < header->name_count; i++) {
+        char *nul = name < end ? (char *)memchr(name, '\0', end - name) : NULL;
+        if (!nul) {
+            valid = 0;
+            break;
+        }
+        bc->names[i] = name;
+        name = nul + 1;
+    }
+
+    if (!valid || name != end || verify(bc->code, bc->length, header) != 0) {
+        fprintf(stderr, "Error: %s: unsupported or corrupt program image\n", path);
+        free_bytecode(bc);
+        return NULL;
+    }
+    return bc;
+}
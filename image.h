@@ -0,0 +1,28 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include "compiler.h"
+
+#define IMAGE_MAGIC "RBYC"
+#define IMAGE_VERSION 1
+
+// Layout, in native byte order: this header, `length` instructions, then
+// `strings_size` bytes holding the NUL-terminated register names.
+typedef struct {
+    char magic[4];
+    int version;
+    int instruction_size;
+    int length;
+    int name_count;
+    int loop_count;
+    int max_stack;
+    int strings_size;
+} ImageHeader;
+
+int image_write(const char *path, Bytecode *bc);
+int image_probe(const char *path);
+
+// Maps the image read-only and runs it in place; only the name index is allocated.
+Bytecode *image_load(const char *path);
+
+#endif
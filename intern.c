@@ -0,0 +1,81 @@
+#include "intern.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERNER_INITIAL_CAPACITY 64
+
+// FNV-1a
+static unsigned int hash_text(const char *text, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void interner_init(Interner *interner, Arena *arena) {
+    interner->arena = arena;
+    interner->slots = NULL;
+    interner->capacity = 0;
+    interner->count = 0;
+}
+
+static void grow(Interner *interner) {
+    int capacity = interner->capacity ? interner->capacity * 2 : INTERNER_INITIAL_CAPACITY;
+    Symbol **slots = (Symbol **)calloc(capacity, sizeof(Symbol *));
+
+    for (int i = 0; i < interner->capacity; i++) {
+        Symbol *symbol = interner->slots[i];
+        if (!symbol) continue;
+
+        unsigned int index = symbol->hash & (capacity - 1);
+        while (slots[index]) {
+            index = (index + 1) & (capacity - 1);
+        }
+        slots[index] = symbol;
+    }
+
+    free(interner->slots);
+    interner->slots = slots;
+    interner->capacity = capacity;
+}
+
+Symbol *interner_intern(Interner *interner, const char *text, size_t length) {
+    // Keep the load factor at or below one half
+    if ((interner->count + 1) * 2 > interner->capacity) {
+        grow(interner);
+    }
+
+    unsigned int hash = hash_text(text, length);
+    unsigned int mask = interner->capacity - 1;
+    unsigned int index = hash & mask;
+
+    Symbol *symbol;
+    while ((symbol = interner->slots[index]) != NULL) {
+        if (symbol->hash == hash && strncmp(symbol->name, text, length) == 0 &&
+            symbol->name[length] == '\0') {
+            return symbol;
+        }
+        index = (index + 1) & mask;
+    }
+
+    // The name is stored right after the symbol, in the same arena allocation
+    symbol = (Symbol *)arena_alloc(interner->arena, sizeof(Symbol) + length + 1);
+    char *name = (char *)(symbol + 1);
+    memcpy(name, text, length);
+    name[length] = '\0';
+
+    symbol->name = name;
+    symbol->hash = hash;
+    symbol->id = interner->count++;
+    interner->slots[index] = symbol;
+    return symbol;
+}
+
+void interner_free(Interner *interner) {
+    free(interner->slots);
+    interner->slots = NULL;
+    interner->capacity = 0;
+    interner->count = 0;
+}
@@ -0,0 +1,28 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include "arena.h"
+
+// An interned identifier. There is exactly one Symbol per distinct spelling in
+// a program, so two identifiers name the same variable iff the pointers match.
+typedef struct {
+    const char *name;
+    unsigned int hash;
+    int id;             // dense, in order of first appearance
+} Symbol;
+
+// Open-addressing hash set of symbols. Symbols and their names live in the
+// arena; only the slot array is on the heap and it grows by doubling.
+typedef struct {
+    Arena *arena;
+    Symbol **slots;
+    int capacity;       // power of two
+    int count;
+} Interner;
+
+void interner_init(Interner *interner, Arena *arena);
+Symbol *interner_intern(Interner *interner, const char *text, size_t length);
+void interner_free(Interner *interner);
+
+#endif
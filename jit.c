@@ -0,0 +1,380 @@
+#include "jit.h"
+#include "fuse.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define JIT_SUPPORTED 1
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef JIT_SUPPORTED
+
+#define JIT_INSTRUCTION_BYTES 64    // upper bound for the largest template
+#define JIT_FRAME_BYTES 64          // prologue and epilogue
+
+typedef void (*JitEntry)(VMContext *ctx, int *registers, int *stack, int *loops);
+
+struct JitCode {
+    void *memory;
+    size_t size;
+    JitEntry entry;
+};
+
+typedef struct {
+    int at;             // offset of a rel32 operand
+    int target;         // bytecode pc it jumps to
+} Fixup;
+
+typedef struct {
+    unsigned char *code;
+    int length;
+    int *labels;        // code offset of each bytecode pc, plus the epilogue
+    Fixup *fixups;
+    int fixup_count;
+    int tracing;
+} Emitter;
+
+// Calls made from generated code. Everything else stays inline.
+static int jit_read(VMContext *ctx, int sensor, int slot) {
+    int value = vm_read_sensor(ctx, (SensorType)sensor);
+    trace_event(&ctx->trace, EVENT_SENSOR, sensor, slot, value);
+    return value;
+}
+
+static void jit_wait(VMContext *ctx, int ms) {
+    trace_event(&ctx->trace, EVENT_WAIT, 0, 0, ms);
+    vm_wait(ctx, ms);
+}
+
+static int jit_divide(int left, int right) {
+    if (right == 0) {
+        fprintf(stderr, "Error: Division by zero\n");
+        return 0;
+    }
+    return left / right;
+}
+
+static void jit_loop_limit(void) {
+    fprintf(stderr, "  [WARNING] Loop exceeded 10000 iterations, breaking\n");
+}
+
+static void jit_trace_var(VMContext *ctx, int slot, int value) {
+    trace_event(&ctx->trace, EVENT_VAR, 0, slot, value);
+}
+
+static int jit_trace_if(VMContext *ctx, int value) {
+    trace_event(&ctx->trace, EVENT_IF, 0, 0, value);
+    return value;
+}
+
+static void jit_trace_loop_enter(VMContext *ctx) {
+    trace_event(&ctx->trace, EVENT_LOOP_ENTER, 0, 0, 0);
+}
+
+static void jit_trace_loop_exit(VMContext *ctx, int iterations) {
+    trace_event(&ctx->trace, EVENT_LOOP_EXIT, 0, 0, iterations);
+}
+
+static void byte(Emitter *e, int b) {
+    e->code[e->length++] = (unsigned char)b;
+}
+
+static void bytes(Emitter *e, const char *s, int count) {
+    for (int i = 0; i < count; i++) {
+        byte(e, (unsigned char)s[i]);
+    }
+}
+
+static void imm32(Emitter *e, int value) {
+    memcpy(e->code + e->length, &value, 4);
+    e->length += 4;
+}
+
+// Register roles: rbx = ctx, r12 = registers, r13 = stack, r14 = loops.
+// The three bases get their own ModRM forms, all with a 32-bit displacement.
+static void stack_op(Emitter *e, const char *op, int count, int slot) {
+    bytes(e, op, count);
+    imm32(e, slot * 4);
+}
+
+#define MOV_EAX_STACK   "\x41\x8b\x85"      // mov eax, [r13 + d]
+#define MOV_ESI_STACK   "\x41\x8b\xb5"      // mov esi, [r13 + d]
+#define MOV_EDI_STACK   "\x41\x8b\xbd"      // mov edi, [r13 + d]
+#define MOV_STACK_EAX   "\x41\x89\x85"      // mov [r13 + d], eax
+#define MOV_STACK_IMM   "\x41\xc7\x85"      // mov dword [r13 + d], imm32
+#define ADD_EAX_STACK   "\x41\x03\x85"      // add eax, [r13 + d]
+#define SUB_EAX_STACK   "\x41\x2b\x85"      // sub eax, [r13 + d]
+#define IMUL_EAX_STACK  "\x41\x0f\xaf\x85"  // imul eax, [r13 + d]
+#define CMP_EAX_STACK   "\x41\x3b\x85"      // cmp eax, [r13 + d]
+#define MOV_EAX_REG     "\x41\x8b\x84\x24"  // mov eax, [r12 + d]
+#define MOV_REG_EAX     "\x41\x89\x84\x24"  // mov [r12 + d], eax
+#define MOV_EAX_LOOP    "\x41\x8b\x86"      // mov eax, [r14 + d]
+#define MOV_ESI_LOOP    "\x41\x8b\xb6"      // mov esi, [r14 + d]
+#define MOV_LOOP_EAX    "\x41\x89\x86"      // mov [r14 + d], eax
+#define MOV_LOOP_IMM    "\x41\xc7\x86"      // mov dword [r14 + d], imm32
+#define MOV_CTX_IMM     "\xc7\x83"          // mov dword [rbx + d], imm32
+
+static void mov_rdi_ctx(Emitter *e) {
+    bytes(e, "\x48\x89\xdf", 3);            // mov rdi, rbx
+}
+
+static void mov_esi_imm(Emitter *e, int value) {
+    byte(e, 0xbe);
+    imm32(e, value);
+}
+
+static void mov_edx_imm(Emitter *e, int value) {
+    byte(e, 0xba);
+    imm32(e, value);
+}
+
+static void call(Emitter *e, void *function) {
+    uint64_t address = (uint64_t)(uintptr_t)function;
+    bytes(e, "\x48\xb8", 2);                // mov rax, imm64
+    memcpy(e->code + e->length, &address, 8);
+    e->length += 8;
+    bytes(e, "\xff\xd0", 2);                // call rax
+}
+
+static void jump(Emitter *e, const char *op, int count, int target) {
+    bytes(e, op, count);
+    e->fixups[e->fixup_count].at = e->length;
+    e->fixups[e->fixup_count].target = target;
+    e->fixup_count++;
+    imm32(e, 0);
+}
+
+static void command(Emitter *e, void *setter, int top) {
+    stack_op(e, MOV_ESI_STACK, 3, top);
+    mov_rdi_ctx(e);
+    call(e, setter);
+}
+
+static void compile_instruction(Emitter *e, const Instruction *ins, int pc, int depth) {
+    int top = depth - 1;
+    // setcc for BC_EQ .. BC_LE
+    const unsigned char setcc[] = {0x94, 0x95, 0x9f, 0x9c, 0x9d, 0x9e};
+
+    // Fused heads are compiled as the instruction they replaced
+    OpCode op = fuse_original(ins);
+    switch (op) {
+        case BC_PUSH:
+            stack_op(e, MOV_STACK_IMM, 3, depth);
+            imm32(e, ins->arg);
+            break;
+
+        case BC_LOAD:
+            stack_op(e, MOV_EAX_REG, 4, ins->arg);
+            stack_op(e, MOV_STACK_EAX, 3, depth);
+            break;
+
+        case BC_STORE:
+            stack_op(e, MOV_EAX_STACK, 3, top);
+            stack_op(e, MOV_REG_EAX, 4, ins->arg);
+            if (e->tracing) {
+                bytes(e, "\x89\xc2", 2);    // mov edx, eax
+                mov_rdi_ctx(e);
+                mov_esi_imm(e, ins->arg);
+                call(e, jit_trace_var);
+            }
+            break;
+
+        case BC_ADD:
+        case BC_SUB:
+        case BC_MUL:
+            stack_op(e, MOV_EAX_STACK, 3, top - 1);
+            if (op == BC_ADD) stack_op(e, ADD_EAX_STACK, 3, top);
+            if (op == BC_SUB) stack_op(e, SUB_EAX_STACK, 3, top);
+            if (op == BC_MUL) stack_op(e, IMUL_EAX_STACK, 4, top);
+            stack_op(e, MOV_STACK_EAX, 3, top - 1);
+            break;
+
+        case BC_DIV:
+            stack_op(e, MOV_EDI_STACK, 3, top - 1);
+            stack_op(e, MOV_ESI_STACK, 3, top);
+            call(e, jit_divide);
+            stack_op(e, MOV_STACK_EAX, 3, top - 1);
+            break;
+
+        case BC_EQ:
+        case BC_NE:
+        case BC_GT:
+        case BC_LT:
+        case BC_GE:
+        case BC_LE:
+            stack_op(e, MOV_EAX_STACK, 3, top - 1);
+            stack_op(e, CMP_EAX_STACK, 3, top);
+            byte(e, 0x0f);
+            byte(e, setcc[op - BC_EQ]);
+            byte(e, 0xc0);                  // setcc al
+            bytes(e, "\x0f\xb6\xc0", 3);    // movzx eax, al
+            stack_op(e, MOV_STACK_EAX, 3, top - 1);
+            break;
+
+        case BC_JUMP:
+            jump(e, "\xe9", 1, ins->arg);
+            break;
+
+        case BC_JUMP_IF_FALSE:
+        case BC_BRANCH:
+            if (op == BC_BRANCH && e->tracing) {
+                stack_op(e, MOV_ESI_STACK, 3, top);
+                mov_rdi_ctx(e);
+                call(e, jit_trace_if);
+            } else {
+                stack_op(e, MOV_EAX_STACK, 3, top);
+            }
+            bytes(e, "\x85\xc0", 2);        // test eax, eax
+            jump(e, "\x0f\x84", 2, ins->arg);
+            break;
+
+        case BC_LOOP_ENTER:
+            if (e->tracing) {
+                mov_rdi_ctx(e);
+                call(e, jit_trace_loop_enter);
+            }
+            // rodeo_clock_invalidate(&ctx->clock)
+            bytes(e, MOV_CTX_IMM, 2);
+            imm32(e, (int)offsetof(VMContext, clock.valid));
+            imm32(e, 0);
+            stack_op(e, MOV_LOOP_IMM, 3, ins->arg);
+            imm32(e, 0);
+            break;
+
+        case BC_LOOP_NEXT:
+            // rodeo_clock_invalidate(&ctx->clock)
+            bytes(e, MOV_CTX_IMM, 2);
+            imm32(e, (int)offsetof(VMContext, clock.valid));
+            imm32(e, 0);
+            // Past the limit, skip the jump back to the loop condition
+            stack_op(e, MOV_EAX_LOOP, 3, ins->arg);
+            bytes(e, "\xff\xc0", 2);        // inc eax
+            stack_op(e, MOV_LOOP_EAX, 3, ins->arg);
+            byte(e, 0x3d);                  // cmp eax, 10000
+            imm32(e, 10000);
+            jump(e, "\x0f\x8e", 2, pc + 1);
+            call(e, jit_loop_limit);
+            jump(e, "\xe9", 1, pc + 2);
+            break;
+
+        case BC_LOOP_EXIT:
+            if (e->tracing) {
+                stack_op(e, MOV_ESI_LOOP, 3, ins->arg);
+                mov_rdi_ctx(e);
+                call(e, jit_trace_loop_exit);
+            }
+            break;
+
+        case BC_SPEED:   command(e, vm_set_speed, top); break;
+        case BC_TORQUE:  command(e, vm_set_torque, top); break;
+        case BC_YAW:     command(e, vm_set_yaw, top); break;
+        case BC_BRAKE:   command(e, vm_set_brake, top); break;
+        case BC_WAIT:    command(e, jit_wait, top); break;
+
+        case BC_PATTERN:
+            mov_rdi_ctx(e);
+            mov_esi_imm(e, ins->aux);
+            call(e, vm_set_pattern);
+            break;
+
+        case BC_READ:
+            mov_rdi_ctx(e);
+            mov_esi_imm(e, ins->aux);
+            mov_edx_imm(e, ins->arg);
+            call(e, jit_read);
+            stack_op(e, MOV_REG_EAX, 4, ins->arg);
+            break;
+
+        default:
+            // BC_HALT
+            jump(e, "\xe9", 1, -1);
+            break;
+    }
+}
+
+JitCode *jit_compile(Bytecode *bc, int tracing) {
+    size_t size = (size_t)bc->length * JIT_INSTRUCTION_BYTES + JIT_FRAME_BYTES;
+    size_t page = 4096;
+    size = (size + page - 1) / page * page;
+
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return NULL;
+
+    Emitter e;
+    e.code = (unsigned char *)memory;
+    e.length = 0;
+    e.labels = (int *)malloc(sizeof(int) * (bc->length + 1));
+    e.fixups = (Fixup *)malloc(sizeof(Fixup) * (bc->length * 2 + 1));
+    e.fixup_count = 0;
+    e.tracing = tracing;
+
+    // Five pushes keep rsp 16-byte aligned for the calls
+    bytes(&e, "\x53\x41\x54\x41\x55\x41\x56\x41\x57", 9);  // push rbx, r12-r15
+    bytes(&e, "\x48\x89\xfb", 3);                          // mov rbx, rdi
+    bytes(&e, "\x49\x89\xf4", 3);                          // mov r12, rsi
+    bytes(&e, "\x49\x89\xd5", 3);                          // mov r13, rdx
+    bytes(&e, "\x49\x89\xce", 3);                          // mov r14, rcx
+
+    int depth = 0;
+    for (int pc = 0; pc < bc->length; pc++) {
+        e.labels[pc] = e.length;
+        compile_instruction(&e, &bc->code[pc], pc, depth);
+        depth += bytecode_stack_effect(fuse_original(&bc->code[pc]));
+    }
+
+    e.labels[bc->length] = e.length;
+    bytes(&e, "\x41\x5f\x41\x5e\x41\x5d\x41\x5c\x5b", 9);  // pop r15-r12, rbx
+    byte(&e, 0xc3);                                        // ret
+
+    for (int i = 0; i < e.fixup_count; i++) {
+        Fixup *f = &e.fixups[i];
+        int target = f->target < 0 ? e.labels[bc->length] : e.labels[f->target];
+        int rel = target - (f->at + 4);
+        memcpy(e.code + f->at, &rel, 4);
+    }
+    free(e.labels);
+    free(e.fixups);
+
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        return NULL;
+    }
+
+    JitCode *jit = (JitCode *)malloc(sizeof(JitCode));
+    jit->memory = memory;
+    jit->size = size;
+    jit->entry = (JitEntry)memory;
+    return jit;
+}
+
+void jit_run(JitCode *jit, VMContext *ctx, int *stack, int *loops) {
+    jit->entry(ctx, ctx->registers, stack, loops);
+}
+
+void jit_free(JitCode *jit) {
+    if (!jit) return;
+    munmap(jit->memory, jit->size);
+    free(jit);
+}
+
+#else
+
+JitCode *jit_compile(Bytecode *bc, int tracing) {
+    (void)bc;
+    (void)tracing;
+    return NULL;
+}
+
+void jit_run(JitCode *jit, VMContext *ctx, int *stack, int *loops) {
+    (void)jit;
+    (void)ctx;
+    (void)stack;
+    (void)loops;
+}
+
+void jit_free(JitCode *jit) {
+    (void)jit;
+}
+
+#endif
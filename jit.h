@@ -0,0 +1,18 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "compiler.h"
+#include "vm.h"
+
+// Template JIT: every bytecode instruction becomes a fixed x86-64 snippet in an
+// mmap'd buffer. Operand stack slots live at fixed offsets, since the stack
+// depth before each instruction is known at compile time.
+typedef struct JitCode JitCode;
+
+// NULL when the platform is not supported or the buffer cannot be mapped.
+// With `tracing` set the code also reports trace events through the VM.
+JitCode *jit_compile(Bytecode *bc, int tracing);
+void jit_run(JitCode *jit, VMContext *ctx, int *stack, int *loops);
+void jit_free(JitCode *jit);
+
+#endif
@@ -0,0 +1,377 @@
+#include "lockstep.h"
+#include "fuse.h"
+#include <limits.h>
+
+// Four machines per vector: one SSE2 register on every x86-64 target, and
+// plain scalar code where GCC has no vector unit to lower it to.
+#define VEC_LANES 4
+
+typedef int LaneVec __attribute__((vector_size(VEC_LANES * sizeof(int))));
+typedef unsigned int LaneUVec __attribute__((vector_size(VEC_LANES * sizeof(int))));
+
+#define HALTED INT_MAX
+#define DIVERGED -1
+
+// Every lane keeps its own pc. Each step runs the instruction at the lowest pc
+// for the lanes sitting on it, so lanes that split at an if or a while exit
+// wait at the join point until the others catch up. The compiler only emits
+// jumps at statement boundaries, where the operand stack is empty, so the
+// stack depth before an instruction is the same for every lane.
+typedef struct {
+    Fleet *fleet;
+    int lanes;          // fleet->capacity
+    int *pc;
+    int *mask;          // -1 for lanes running the current instruction
+    int *registers;     // [slot][lane]
+    int *stack;         // [depth][lane]
+    int *loops;         // [loop][lane]
+    int *depth;         // stack depth before each instruction
+} Lockstep;
+
+static int *lane_rows(int rows, int lanes) {
+    void *ptr = NULL;
+    size_t size = sizeof(int) * (size_t)(rows > 0 ? rows : 1) * lanes;
+    if (posix_memalign(&ptr, 32, size) != 0) return NULL;
+    memset(ptr, 0, size);
+    return (int *)ptr;
+}
+
+static void compute_depths(Bytecode *bc, int *depth) {
+    int d = 0;
+    for (int pc = 0; pc < bc->length; pc++) {
+        depth[pc] = d;
+        d += bytecode_stack_effect(fuse_original(&bc->code[pc]));
+    }
+}
+
+// Picks the lowest pc and masks the lanes on it. `waiting` is the lowest pc
+// of every other lane still running.
+static int schedule(Lockstep *ls, int count, int *first, int *last, int *waiting) {
+    int pc = HALTED;
+    int second = HALTED;
+    for (int i = 0; i < count; i++) {
+        if (ls->pc[i] < pc) {
+            second = pc;
+            pc = ls->pc[i];
+        } else if (ls->pc[i] > pc && ls->pc[i] < second) {
+            second = ls->pc[i];
+        }
+    }
+
+    *first = -1;
+    *last = -1;
+    for (int i = 0; i < ls->lanes; i++) {
+        int active = ls->pc[i] == pc && pc != HALTED;
+        ls->mask[i] = -active;
+        if (active) {
+            if (*first < 0) *first = i;
+            *last = i;
+        }
+    }
+    *waiting = second;
+    return pc;
+}
+
+// The pc every running lane moved to, or DIVERGED if they went different ways.
+static int common_pc(Lockstep *ls, int first, int last) {
+    int target = -1;
+    for (int i = first; i <= last; i++) {
+        if (!ls->mask[i]) continue;
+        if (target < 0) {
+            target = ls->pc[i];
+        } else if (ls->pc[i] != target) {
+            return DIVERGED;
+        }
+    }
+    return target;
+}
+
+static inline LaneVec select_lanes(LaneVec mask, LaneVec a, LaneVec b) {
+    return (mask & a) | (~mask & b);
+}
+
+static inline LaneVec splat(int value) {
+    LaneVec v;
+    for (int i = 0; i < VEC_LANES; i++) v[i] = value;
+    return v;
+}
+
+#define ROW(ls, base, index) ((LaneVec *)((base) + (size_t)(index) * (ls)->lanes))
+
+// Runs `body` for every vector holding an active lane, with `m` its lane mask.
+#define FOR_LANES(ls, first, last, body) \
+    for (int v = (first) / VEC_LANES; v <= (last) / VEC_LANES; v++) { \
+        LaneVec m = ((LaneVec *)(ls)->mask)[v]; \
+        body \
+    }
+
+static void store_field(Lockstep *ls, int *field, LaneVec *values, int first, int last) {
+    LaneVec *dst = (LaneVec *)field;
+    FOR_LANES(ls, first, last, {
+        dst[v] = select_lanes(m, values[v], dst[v]);
+    })
+}
+
+static void read_sensor(Lockstep *ls, SensorType sensor, LaneVec *dst, int first, int last) {
+    Fleet *fleet = ls->fleet;
+    fleet_simulate_sensors(fleet, ls->mask);
+
+    int *field = NULL;
+    switch (sensor) {
+        case SENSOR_RIDER: field = fleet->rider_present; break;
+        case SENSOR_TILT: field = fleet->tilt_angle; break;
+        case SENSOR_RPM: field = fleet->rpm; break;
+        case SENSOR_EMERGENCY: field = fleet->emergency; break;
+        case SENSOR_TIME_MS:
+            for (int i = first; i <= last; i++) {
+                if (ls->mask[i]) ((int *)dst)[i] = (int)fleet->sim_time_ms[i];
+            }
+            return;
+        case SENSOR_TIME_US:
+            for (int i = first; i <= last; i++) {
+                if (ls->mask[i]) ((int *)dst)[i] = (int)(fleet->sim_time_ms[i] * 1000);
+            }
+            return;
+    }
+
+    LaneVec *src = (LaneVec *)field;
+    FOR_LANES(ls, first, last, {
+        dst[v] = select_lanes(m, src[v], dst[v]);
+    })
+}
+
+static void clamp_percent(Lockstep *ls, LaneVec *values, int first, int last) {
+    const LaneVec zero = splat(0);
+    const LaneVec hundred = splat(100);
+    FOR_LANES(ls, first, last, {
+        LaneVec x = values[v];
+        x = select_lanes(x < zero, zero, x);
+        x = select_lanes(x > hundred, hundred, x);
+        values[v] = select_lanes(m, x, values[v]);
+    })
+}
+
+static void free_lanes(Lockstep *ls) {
+    free(ls->depth);
+    free(ls->loops);
+    free(ls->stack);
+    free(ls->registers);
+    free(ls->mask);
+    free(ls->pc);
+}
+
+int lockstep_run(Fleet *fleet, Bytecode *bc) {
+    Lockstep ls;
+    int lanes = fleet->capacity;
+    ls.fleet = fleet;
+    ls.lanes = lanes;
+    ls.pc = lane_rows(1, lanes);
+    ls.mask = lane_rows(1, lanes);
+    ls.registers = lane_rows(bc->name_count, lanes);
+    ls.stack = lane_rows(bc->max_stack + 1, lanes);
+    ls.loops = lane_rows(bc->loop_count, lanes);
+    ls.depth = (int *)malloc(sizeof(int) * bc->length);
+    if (!ls.pc || !ls.mask || !ls.registers || !ls.stack || !ls.loops || !ls.depth) {
+        fprintf(stderr, "Error: not enough memory to run the program\n");
+        free_lanes(&ls);
+        return -1;
+    }
+    compute_depths(bc, ls.depth);
+
+    for (int i = 0; i < lanes; i++) {
+        ls.pc[i] = i < fleet->count ? 0 : HALTED;
+    }
+
+    const Instruction *code = bc->code;
+    const LaneVec one = splat(1);
+    const LaneVec zero = splat(0);
+
+    int first, last, waiting;
+    int pc = schedule(&ls, fleet->count, &first, &last, &waiting);
+    while (pc != HALTED) {
+        const Instruction *ins = &code[pc];
+        int sp = ls.depth[pc];
+        LaneVec *top = sp > 0 ? ROW(&ls, ls.stack, sp - 1) : NULL;
+        LaneVec *below = sp > 1 ? ROW(&ls, ls.stack, sp - 2) : NULL;
+        int next = pc + 1;
+
+        // Fused heads run as the instruction they replaced
+        switch (fuse_original(ins)) {
+            case BC_PUSH:
+                {
+                    LaneVec *dst = ROW(&ls, ls.stack, sp);
+                    LaneVec value = splat(ins->arg);
+                    FOR_LANES(&ls, first, last, { dst[v] = select_lanes(m, value, dst[v]); })
+                }
+                break;
+
+            case BC_LOAD:
+                {
+                    LaneVec *dst = ROW(&ls, ls.stack, sp);
+                    LaneVec *src = ROW(&ls, ls.registers, ins->arg);
+                    FOR_LANES(&ls, first, last, { dst[v] = select_lanes(m, src[v], dst[v]); })
+                }
+                break;
+
+            case BC_STORE:
+                {
+                    LaneVec *dst = ROW(&ls, ls.registers, ins->arg);
+                    FOR_LANES(&ls, first, last, { dst[v] = select_lanes(m, top[v], dst[v]); })
+                }
+                break;
+
+            // Unsigned vectors give the wrapping arithmetic of the scalar VM
+            case BC_ADD:
+                FOR_LANES(&ls, first, last, {
+                    LaneVec r = (LaneVec)((LaneUVec)below[v] + (LaneUVec)top[v]);
+                    below[v] = select_lanes(m, r, below[v]);
+                })
+                break;
+            case BC_SUB:
+                FOR_LANES(&ls, first, last, {
+                    LaneVec r = (LaneVec)((LaneUVec)below[v] - (LaneUVec)top[v]);
+                    below[v] = select_lanes(m, r, below[v]);
+                })
+                break;
+            case BC_MUL:
+                FOR_LANES(&ls, first, last, {
+                    LaneVec r = (LaneVec)((LaneUVec)below[v] * (LaneUVec)top[v]);
+                    below[v] = select_lanes(m, r, below[v]);
+                })
+                break;
+
+            case BC_DIV:
+                // No vector integer divide; lanes are handled one at a time
+                for (int i = first; i <= last; i++) {
+                    if (!ls.mask[i]) continue;
+                    int *l = (int *)below + i;
+                    int r = ((int *)top)[i];
+                    if (r == 0) {
+                        fprintf(stderr, "Error: Division by zero\n");
+                        *l = 0;
+                    } else if (!(r == -1 && *l == INT_MIN)) {
+                        *l = *l / r;
+                    }
+                }
+                break;
+
+            case BC_EQ:
+                FOR_LANES(&ls, first, last, { below[v] = select_lanes(m, (below[v] == top[v]) & one, below[v]); })
+                break;
+            case BC_NE:
+                FOR_LANES(&ls, first, last, { below[v] = select_lanes(m, (below[v] != top[v]) & one, below[v]); })
+                break;
+            case BC_GT:
+                FOR_LANES(&ls, first, last, { below[v] = select_lanes(m, (below[v] > top[v]) & one, below[v]); })
+                break;
+            case BC_LT:
+                FOR_LANES(&ls, first, last, { below[v] = select_lanes(m, (below[v] < top[v]) & one, below[v]); })
+                break;
+            case BC_GE:
+                FOR_LANES(&ls, first, last, { below[v] = select_lanes(m, (below[v] >= top[v]) & one, below[v]); })
+                break;
+            case BC_LE:
+                FOR_LANES(&ls, first, last, { below[v] = select_lanes(m, (below[v] <= top[v]) & one, below[v]); })
+                break;
+
+            case BC_JUMP:
+                next = ins->arg;
+                break;
+
+            case BC_JUMP_IF_FALSE:
+            case BC_BRANCH:
+                // Lanes may split here: each one follows its own condition
+                for (int i = first; i <= last; i++) {
+                    if (ls.mask[i]) ls.pc[i] = ((int *)top)[i] ? pc + 1 : ins->arg;
+                }
+                next = common_pc(&ls, first, last);
+                break;
+
+            case BC_LOOP_ENTER:
+                {
+                    LaneVec *count = ROW(&ls, ls.loops, ins->arg);
+                    FOR_LANES(&ls, first, last, { count[v] = select_lanes(m, zero, count[v]); })
+                }
+                break;
+
+            case BC_LOOP_NEXT:
+                {
+                    int *count = ls.loops + (size_t)ins->arg * lanes;
+                    for (int i = first; i <= last; i++) {
+                        if (!ls.mask[i]) continue;
+                        ls.pc[i] = pc + 1;
+                        if (++count[i] > 10000) {
+                            fprintf(stderr, "  [WARNING] Loop exceeded 10000 iterations, breaking\n");
+                            ls.pc[i] = pc + 2;
+                        }
+                    }
+                    next = common_pc(&ls, first, last);
+                }
+                break;
+
+            case BC_LOOP_EXIT:
+                break;
+
+            case BC_SPEED:
+                clamp_percent(&ls, top, first, last);
+                store_field(&ls, fleet->speed, top, first, last);
+                break;
+
+            case BC_TORQUE:
+                clamp_percent(&ls, top, first, last);
+                store_field(&ls, fleet->torque, top, first, last);
+                break;
+
+            case BC_YAW:
+                store_field(&ls, fleet->yaw, top, first, last);
+                break;
+
+            case BC_BRAKE:
+                FOR_LANES(&ls, first, last, { top[v] = select_lanes(m, (top[v] != zero) & one, top[v]); })
+                store_field(&ls, fleet->brake, top, first, last);
+                break;
+
+            case BC_WAIT:
+                for (int i = first; i <= last; i++) {
+                    int ms = ((int *)top)[i];
+                    if (ls.mask[i] && ms > 0) fleet->sim_time_ms[i] += ms;
+                }
+                break;
+
+            case BC_PATTERN:
+                {
+                    LaneVec pattern = splat(ins->aux);
+                    LaneVec *dst = (LaneVec *)fleet->pattern;
+                    FOR_LANES(&ls, first, last, { dst[v] = select_lanes(m, pattern, dst[v]); })
+                }
+                break;
+
+            case BC_READ:
+                read_sensor(&ls, (SensorType)ins->aux, ROW(&ls, ls.registers, ins->arg), first, last);
+                break;
+
+            case BC_HALT:
+                next = HALTED;
+                break;
+
+            default:
+                break;
+        }
+
+        // While the running lanes stay together and no waiting lane is due,
+        // keep the mask; the per-lane pcs are only written back on a reschedule
+        if (next != DIVERGED && next < waiting) {
+            pc = next;
+            continue;
+        }
+        if (next != DIVERGED) {
+            for (int i = first; i <= last; i++) {
+                if (ls.mask[i]) ls.pc[i] = next;
+            }
+        }
+        pc = schedule(&ls, fleet->count, &first, &last, &waiting);
+    }
+
+    free_lanes(&ls);
+    return 0;
+}
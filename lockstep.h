@@ -0,0 +1,12 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include "compiler.h"
+#include "fleet.h"
+
+// Runs one program on every machine of the fleet at once, starting from the
+// fleet's current state. Always uses the virtual clock and does not trace.
+// Returns -1 if the per-lane state cannot be allocated.
+int lockstep_run(Fleet *fleet, Bytecode *bc);
+
+#endif
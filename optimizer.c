@@ -0,0 +1,200 @@
+#include "optimizer.h"
+#include <limits.h>
+
+typedef struct {
+    int *writes;        // assignments and sensor reads per slot
+    int *known;         // slot holds a propagated constant
+    int *values;
+} Optimizer;
+
+static int fold_binary(BinaryOp op, int left, int right, int *result) {
+    unsigned int l = (unsigned int)left;
+    unsigned int r = (unsigned int)right;
+
+    switch (op) {
+        case OP_ADD: *result = (int)(l + r); return 1;
+        case OP_SUB: *result = (int)(l - r); return 1;
+        case OP_MUL: *result = (int)(l * r); return 1;
+        case OP_DIV:
+            // Leave division by zero to the VM so the error is still reported
+            if (right == 0 || (left == INT_MIN && right == -1)) return 0;
+            *result = left / right;
+            return 1;
+    }
+    return 0;
+}
+
+static int has_division(Expression *expr) {
+    if (!expr || expr->type != EXPR_BINARY_OP) return 0;
+    if (expr->data.binary.op == OP_DIV) return 1;
+    return has_division(expr->data.binary.left) || has_division(expr->data.binary.right);
+}
+
+static void set_number(Expression *expr, int value) {
+    expr->type = EXPR_NUMBER;
+    expr->data.number = value;
+}
+
+static void optimize_expression(Optimizer *opt, Expression *expr) {
+    if (!expr) return;
+
+    switch (expr->type) {
+        case EXPR_NUMBER:
+            return;
+
+        case EXPR_IDENTIFIER:
+            {
+                int slot = expr->data.identifier.slot;
+                if (slot >= 0 && opt->known[slot]) {
+                    set_number(expr, opt->values[slot]);
+                }
+            }
+            return;
+
+        case EXPR_BINARY_OP:
+            break;
+    }
+
+    BinaryOp op = expr->data.binary.op;
+    Expression *left = expr->data.binary.left;
+    Expression *right = expr->data.binary.right;
+    optimize_expression(opt, left);
+    optimize_expression(opt, right);
+
+    int value;
+    if (left->type == EXPR_NUMBER && right->type == EXPR_NUMBER) {
+        if (fold_binary(op, left->data.number, right->data.number, &value)) {
+            set_number(expr, value);
+        }
+    } else if (right->type == EXPR_NUMBER) {
+        int r = right->data.number;
+        if (((op == OP_ADD || op == OP_SUB) && r == 0) ||
+            ((op == OP_MUL || op == OP_DIV) && r == 1)) {
+            *expr = *left;
+        } else if (op == OP_MUL && r == 0 && !has_division(left)) {
+            set_number(expr, 0);
+        }
+    } else if (left->type == EXPR_NUMBER) {
+        int l = left->data.number;
+        if ((op == OP_ADD && l == 0) || (op == OP_MUL && l == 1)) {
+            *expr = *right;
+        } else if (op == OP_MUL && l == 0 && !has_division(right)) {
+            set_number(expr, 0);
+        }
+    }
+}
+
+static void optimize_condition(Optimizer *opt, Condition *cond) {
+    if (!cond) return;
+    optimize_expression(opt, cond->left);
+    optimize_expression(opt, cond->right);
+}
+
+static void count_writes(Optimizer *opt, ASTNode *list) {
+    for (ASTNode *stmt = list; stmt; stmt = stmt->next) {
+        switch (stmt->type) {
+            case STMT_ASSIGNMENT:
+                opt->writes[stmt->data.assignment.slot]++;
+                break;
+            case STMT_SENSOR_READ:
+                opt->writes[stmt->data.sensor_read.slot]++;
+                break;
+            case STMT_IF:
+                count_writes(opt, stmt->data.if_stmt.then_block);
+                count_writes(opt, stmt->data.if_stmt.else_block);
+                break;
+            case STMT_WHILE:
+                count_writes(opt, stmt->data.while_stmt.body);
+                break;
+            case STMT_BLOCK:
+                for (int i = 0; i < stmt->data.block.count; i++) {
+                    count_writes(opt, stmt->data.block.statements[i]);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Constants are only propagated from top-level assignments: those run exactly
+// once, before every statement that follows them in the program.
+static void optimize_list(Optimizer *opt, ASTNode *list, int top_level);
+
+static void optimize_statement(Optimizer *opt, ASTNode *stmt, int top_level) {
+    switch (stmt->type) {
+        case STMT_ASSIGNMENT:
+            {
+                Expression *expr = stmt->data.assignment.expr;
+                int slot = stmt->data.assignment.slot;
+                optimize_expression(opt, expr);
+                if (top_level && opt->writes[slot] == 1 && expr && expr->type == EXPR_NUMBER) {
+                    opt->known[slot] = 1;
+                    opt->values[slot] = expr->data.number;
+                }
+            }
+            break;
+
+        case STMT_IF:
+            optimize_condition(opt, stmt->data.if_stmt.condition);
+            optimize_list(opt, stmt->data.if_stmt.then_block, 0);
+            optimize_list(opt, stmt->data.if_stmt.else_block, 0);
+            break;
+
+        case STMT_WHILE:
+            optimize_condition(opt, stmt->data.while_stmt.condition);
+            optimize_list(opt, stmt->data.while_stmt.body, 0);
+            break;
+
+        case STMT_SPEED:
+            optimize_expression(opt, stmt->data.speed_cmd.expr);
+            break;
+
+        case STMT_TORQUE:
+            optimize_expression(opt, stmt->data.torque_cmd.expr);
+            break;
+
+        case STMT_YAW:
+            optimize_expression(opt, stmt->data.yaw_cmd.expr);
+            break;
+
+        case STMT_BRAKE:
+            optimize_expression(opt, stmt->data.brake_cmd.expr);
+            break;
+
+        case STMT_WAIT:
+            optimize_expression(opt, stmt->data.wait_cmd.expr);
+            break;
+
+        case STMT_PATTERN:
+        case STMT_SENSOR_READ:
+            break;
+
+        case STMT_BLOCK:
+            for (int i = 0; i < stmt->data.block.count; i++) {
+                optimize_statement(opt, stmt->data.block.statements[i], top_level);
+            }
+            break;
+    }
+}
+
+static void optimize_list(Optimizer *opt, ASTNode *list, int top_level) {
+    for (ASTNode *stmt = list; stmt; stmt = stmt->next) {
+        optimize_statement(opt, stmt, top_level);
+    }
+}
+
+void optimize_program(ASTNode *program, SymbolTable *symbols) {
+    int n = symbols->count + 1;
+    Optimizer opt;
+    opt.writes = (int *)calloc(n, sizeof(int));
+    opt.known = (int *)calloc(n, sizeof(int));
+    opt.values = (int *)calloc(n, sizeof(int));
+
+    count_writes(&opt, program);
+    optimize_list(&opt, program, 1);
+
+    free(opt.writes);
+    free(opt.known);
+    free(opt.values);
+}
@@ -0,0 +1,9 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "ast.h"
+#include "resolver.h"
+
+void optimize_program(ASTNode *program, SymbolTable *symbols);
+
+#endif
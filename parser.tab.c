@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton implementation for Bison's Yacc-like parsers in C
+/* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -36,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -43,111 +45,28 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.3"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
-
-/* Using locations.  */
-#define YYLSP_NEEDED 0
-
-
-
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     IF = 258,
-     ELSE = 259,
-     WHILE = 260,
-     SPEED = 261,
-     TORQUE = 262,
-     YAW = 263,
-     BRAKE = 264,
-     WAIT = 265,
-     PATTERN = 266,
-     READ = 267,
-     CALM = 268,
-     SWIRL = 269,
-     AGGRESSIVE = 270,
-     RIDER = 271,
-     TILT = 272,
-     RPM = 273,
-     EMERGENCY = 274,
-     TIME_MS = 275,
-     EQ = 276,
-     NE = 277,
-     GE = 278,
-     LE = 279,
-     GT = 280,
-     LT = 281,
-     ASSIGN = 282,
-     PLUS = 283,
-     MINUS = 284,
-     MULT = 285,
-     DIV = 286,
-     LPAREN = 287,
-     RPAREN = 288,
-     LBRACE = 289,
-     RBRACE = 290,
-     SEMICOLON = 291,
-     ARROW = 292,
-     IDENTIFIER = 293,
-     NUMBER = 294
-   };
-#endif
-/* Tokens.  */
-#define IF 258
-#define ELSE 259
-#define WHILE 260
-#define SPEED 261
-#define TORQUE 262
-#define YAW 263
-#define BRAKE 264
-#define WAIT 265
-#define PATTERN 266
-#define READ 267
-#define CALM 268
-#define SWIRL 269
-#define AGGRESSIVE 270
-#define RIDER 271
-#define TILT 272
-#define RPM 273
-#define EMERGENCY 274
-#define TIME_MS 275
-#define EQ 276
-#define NE 277
-#define GE 278
-#define LE 279
-#define GT 280
-#define LT 281
-#define ASSIGN 282
-#define PLUS 283
-#define MINUS 284
-#define MULT 285
-#define DIV 286
-#define LPAREN 287
-#define RPAREN 288
-#define LBRACE 289
-#define RBRACE 290
-#define SEMICOLON 291
-#define ARROW 292
-#define IDENTIFIER 293
-#define NUMBER 294
-
-
-
-
-/* Copy the first part of user declarations.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
 #line 1 "parser.y"
 
 #include <stdio.h>
@@ -155,95 +74,204 @@
 #include <string.h>
 #include "ast.h"
 #include "vm.h"
+#include "batch.h"
+#include "fleet.h"
+#include "image.h"
+#include "fuse.h"
+#include "emit_c.h"
+#include "backend.h"
+#include <unistd.h>
+
+#line 86 "parser.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
-extern int yylex();
-extern int yyparse();
-extern FILE *yyin;
-extern int line_num;
-
-void yyerror(const char *s);
+#include "parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IF = 3,                         /* IF  */
+  YYSYMBOL_ELSE = 4,                       /* ELSE  */
+  YYSYMBOL_WHILE = 5,                      /* WHILE  */
+  YYSYMBOL_SPEED = 6,                      /* SPEED  */
+  YYSYMBOL_TORQUE = 7,                     /* TORQUE  */
+  YYSYMBOL_YAW = 8,                        /* YAW  */
+  YYSYMBOL_BRAKE = 9,                      /* BRAKE  */
+  YYSYMBOL_WAIT = 10,                      /* WAIT  */
+  YYSYMBOL_PATTERN = 11,                   /* PATTERN  */
+  YYSYMBOL_READ = 12,                      /* READ  */
+  YYSYMBOL_CALM = 13,                      /* CALM  */
+  YYSYMBOL_SWIRL = 14,                     /* SWIRL  */
+  YYSYMBOL_AGGRESSIVE = 15,                /* AGGRESSIVE  */
+  YYSYMBOL_RIDER = 16,                     /* RIDER  */
+  YYSYMBOL_TILT = 17,                      /* TILT  */
+  YYSYMBOL_RPM = 18,                       /* RPM  */
+  YYSYMBOL_EMERGENCY = 19,                 /* EMERGENCY  */
+  YYSYMBOL_TIME_MS = 20,                   /* TIME_MS  */
+  YYSYMBOL_TIME_US = 21,                   /* TIME_US  */
+  YYSYMBOL_EQ = 22,                        /* EQ  */
+  YYSYMBOL_NE = 23,                        /* NE  */
+  YYSYMBOL_GE = 24,                        /* GE  */
+  YYSYMBOL_LE = 25,                        /* LE  */
+  YYSYMBOL_GT = 26,                        /* GT  */
+  YYSYMBOL_LT = 27,                        /* LT  */
+  YYSYMBOL_ASSIGN = 28,                    /* ASSIGN  */
+  YYSYMBOL_PLUS = 29,                      /* PLUS  */
+  YYSYMBOL_MINUS = 30,                     /* MINUS  */
+  YYSYMBOL_MULT = 31,                      /* MULT  */
+  YYSYMBOL_DIV = 32,                       /* DIV  */
+  YYSYMBOL_LPAREN = 33,                    /* LPAREN  */
+  YYSYMBOL_RPAREN = 34,                    /* RPAREN  */
+  YYSYMBOL_LBRACE = 35,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 36,                    /* RBRACE  */
+  YYSYMBOL_SEMICOLON = 37,                 /* SEMICOLON  */
+  YYSYMBOL_ARROW = 38,                     /* ARROW  */
+  YYSYMBOL_IDENTIFIER = 39,                /* IDENTIFIER  */
+  YYSYMBOL_NUMBER = 40,                    /* NUMBER  */
+  YYSYMBOL_YYACCEPT = 41,                  /* $accept  */
+  YYSYMBOL_program = 42,                   /* program  */
+  YYSYMBOL_statement_list = 43,            /* statement_list  */
+  YYSYMBOL_statement = 44,                 /* statement  */
+  YYSYMBOL_assignment = 45,                /* assignment  */
+  YYSYMBOL_if_stmt = 46,                   /* if_stmt  */
+  YYSYMBOL_while_stmt = 47,                /* while_stmt  */
+  YYSYMBOL_command = 48,                   /* command  */
+  YYSYMBOL_speed_cmd = 49,                 /* speed_cmd  */
+  YYSYMBOL_torque_cmd = 50,                /* torque_cmd  */
+  YYSYMBOL_yaw_cmd = 51,                   /* yaw_cmd  */
+  YYSYMBOL_brake_cmd = 52,                 /* brake_cmd  */
+  YYSYMBOL_wait_cmd = 53,                  /* wait_cmd  */
+  YYSYMBOL_pattern_cmd = 54,               /* pattern_cmd  */
+  YYSYMBOL_sensor_cmd = 55,                /* sensor_cmd  */
+  YYSYMBOL_expression = 56,                /* expression  */
+  YYSYMBOL_term = 57,                      /* term  */
+  YYSYMBOL_condition = 58,                 /* condition  */
+  YYSYMBOL_relop = 59,                     /* relop  */
+  YYSYMBOL_mode = 60,                      /* mode  */
+  YYSYMBOL_sensor = 61                     /* sensor  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-ASTNode *root_program = NULL;
 
 
-/* Enabling traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
+/* Unqualified %code blocks.  */
+#line 20 "parser.y"
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
+// Dispatches to the Flex or the hand-written scanner (frontend.c)
+int rodeo_lex(YYSTYPE *lvalp, void *scanner);
+#define yylex rodeo_lex
+void yyerror(RodeoProgram *program, void *scanner, const char *s);
 
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-# define YYTOKEN_TABLE 0
-#endif
+#line 189 "parser.tab.c"
 
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 18 "parser.y"
-{
-    int number;
-    char *string;
-    Expression *expr;
-    Condition *cond;
-    ASTNode *stmt;
-    ASTNode *stmt_list;
-    BinaryOp binop;
-    RelOp relop;
-    Pattern pattern;
-    SensorType sensor;
-}
-/* Line 193 of yacc.c.  */
-#line 204 "parser.tab.c"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
-# define YYSTYPE_IS_TRIVIAL 1
+#ifdef short
+# undef short
 #endif
 
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
 
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
 
-/* Copy the second part of user declarations.  */
-
-
-/* Line 216 of yacc.c.  */
-#line 217 "parser.tab.c"
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
 
-#ifdef short
-# undef short
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef unsigned char yytype_uint8;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-typedef signed char yytype_int8;
-#else
-typedef short int yytype_int8;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -251,55 +279,106 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
 #   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(msgid) msgid
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(e) ((void) (e))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int i)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (i)
-    int i;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return i;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -316,11 +395,11 @@ YYID (i)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#     ifndef _STDLIB_H
-#      define _STDLIB_H 1
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
 #     endif
 #    endif
 #   endif
@@ -328,8 +407,8 @@ YYID (i)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -343,111 +422,117 @@ YYID (i)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
 #   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
 #  endif
-#  if (defined __cplusplus && ! defined _STDLIB_H \
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef _STDLIB_H
-#    define _STDLIB_H 1
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
 #   endif
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss;
-  YYSTYPE yyvs;
-  };
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(To, From, Count) \
-      __builtin_memcpy (To, From, (Count) * sizeof (*(From)))
-#  else
-#   define YYCOPY(To, From, Count)		\
-      do					\
-	{					\
-	  YYSIZE_T yyi;				\
-	  for (yyi = 0; yyi < (Count); yyi++)	\
-	    (To)[yyi] = (From)[yyi];		\
-	}					\
-      while (YYID (0))
-#  endif
-# endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack)					\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack, Stack, yysize);				\
-	Stack = &yyptr->Stack;						\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  35
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   187
+#define YYLAST   188
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  40
+#define YYNTOKENS  41
 /* YYNNTS -- Number of nonterminals.  */
 #define YYNNTS  21
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  53
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES  113
+#define YYNRULES  54
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  114
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   295
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   294
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -478,114 +563,85 @@ static const yytype_uint8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39
+      35,    36,    37,    38,    39,    40
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-{
-       0,     0,     3,     4,     6,     8,    11,    13,    15,    17,
-      19,    24,    32,    44,    51,    62,    70,    77,    80,    83,
-      86,    89,    92,    95,    97,   102,   107,   112,   117,   122,
-     127,   135,   137,   141,   145,   149,   153,   155,   157,   161,
-     165,   167,   169,   171,   173,   175,   177,   179,   181,   183,
-     185,   187,   189,   191
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      41,     0,    -1,    -1,    42,    -1,    43,    -1,    42,    43,
-      -1,    44,    -1,    45,    -1,    46,    -1,    47,    -1,    38,
-      27,    55,    36,    -1,     3,    32,    57,    33,    34,    42,
-      35,    -1,     3,    32,    57,    33,    34,    42,    35,     4,
-      34,    42,    35,    -1,     3,    32,    57,    33,    34,    35,
-      -1,     3,    32,    57,    33,    34,    35,     4,    34,    42,
-      35,    -1,     5,    32,    57,    33,    34,    42,    35,    -1,
-       5,    32,    57,    33,    34,    35,    -1,    48,    36,    -1,
-      49,    36,    -1,    50,    36,    -1,    51,    36,    -1,    52,
-      36,    -1,    53,    36,    -1,    54,    -1,     6,    32,    55,
-      33,    -1,     7,    32,    55,    33,    -1,     8,    32,    55,
-      33,    -1,     9,    32,    55,    33,    -1,    10,    32,    55,
-      33,    -1,    11,    32,    59,    33,    -1,    12,    32,    60,
-      33,    37,    38,    36,    -1,    56,    -1,    55,    28,    56,
-      -1,    55,    29,    56,    -1,    55,    30,    56,    -1,    55,
-      31,    56,    -1,    39,    -1,    38,    -1,    32,    55,    33,
-      -1,    55,    58,    55,    -1,    21,    -1,    22,    -1,    25,
-      -1,    26,    -1,    23,    -1,    24,    -1,    13,    -1,    14,
-      -1,    15,    -1,    16,    -1,    17,    -1,    18,    -1,    19,
-      -1,    20,    -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    56,    56,    60,    67,    70,    81,    82,    83,    84,
-      88,    95,    98,   101,   104,   110,   113,   119,   120,   121,
-     122,   123,   124,   125,   129,   135,   141,   147,   153,   159,
-     165,   172,   175,   178,   181,   184,   190,   193,   197,   203,
-     209,   210,   211,   212,   213,   214,   218,   219,   220,   224,
-     225,   226,   227,   228
+       0,    70,    70,    74,    81,    85,    92,    93,    94,    95,
+      99,   105,   108,   111,   114,   120,   123,   129,   130,   131,
+     132,   133,   134,   135,   139,   145,   151,   157,   163,   169,
+     175,   181,   184,   187,   190,   193,   199,   202,   205,   211,
+     217,   218,   219,   220,   221,   222,   226,   227,   228,   232,
+     233,   234,   235,   236,   237
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "IF", "ELSE", "WHILE", "SPEED", "TORQUE",
-  "YAW", "BRAKE", "WAIT", "PATTERN", "READ", "CALM", "SWIRL", "AGGRESSIVE",
-  "RIDER", "TILT", "RPM", "EMERGENCY", "TIME_MS", "EQ", "NE", "GE", "LE",
-  "GT", "LT", "ASSIGN", "PLUS", "MINUS", "MULT", "DIV", "LPAREN", "RPAREN",
-  "LBRACE", "RBRACE", "SEMICOLON", "ARROW", "IDENTIFIER", "NUMBER",
-  "$accept", "program", "statement_list", "statement", "assignment",
-  "if_stmt", "while_stmt", "command", "speed_cmd", "torque_cmd", "yaw_cmd",
-  "brake_cmd", "wait_cmd", "pattern_cmd", "sensor_cmd", "expression",
-  "term", "condition", "relop", "mode", "sensor", 0
+  "\"end of file\"", "error", "\"invalid token\"", "IF", "ELSE", "WHILE",
+  "SPEED", "TORQUE", "YAW", "BRAKE", "WAIT", "PATTERN", "READ", "CALM",
+  "SWIRL", "AGGRESSIVE", "RIDER", "TILT", "RPM", "EMERGENCY", "TIME_MS",
+  "TIME_US", "EQ", "NE", "GE", "LE", "GT", "LT", "ASSIGN", "PLUS", "MINUS",
+  "MULT", "DIV", "LPAREN", "RPAREN", "LBRACE", "RBRACE", "SEMICOLON",
+  "ARROW", "IDENTIFIER", "NUMBER", "$accept", "program", "statement_list",
+  "statement", "assignment", "if_stmt", "while_stmt", "command",
+  "speed_cmd", "torque_cmd", "yaw_cmd", "brake_cmd", "wait_cmd",
+  "pattern_cmd", "sensor_cmd", "expression", "term", "condition", "relop",
+  "mode", "sensor", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    40,    41,    41,    42,    42,    43,    43,    43,    43,
-      44,    45,    45,    45,    45,    46,    46,    47,    47,    47,
-      47,    47,    47,    47,    48,    49,    50,    51,    52,    53,
-      54,    55,    55,    55,    55,    55,    56,    56,    56,    57,
-      58,    58,    58,    58,    58,    58,    59,    59,    59,    60,
-      60,    60,    60,    60
-};
+#define YYPACT_NINF (-58)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
 {
-       0,     2,     0,     1,     1,     2,     1,     1,     1,     1,
-       4,     7,    11,     6,    10,     7,     6,     2,     2,     2,
-       2,     2,     2,     1,     4,     4,     4,     4,     4,     4,
-       7,     1,     3,     3,     3,     3,     1,     1,     3,     3,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1
+     115,   -27,   -14,    -4,     9,    16,    29,    41,    55,    57,
+      91,    98,   115,   -58,   -58,   -58,   -58,   -58,    64,    97,
+     102,   103,   112,   114,   -58,     8,     8,     8,     8,     8,
+       8,     8,    31,    39,     8,   -58,   -58,   -58,   -58,   -58,
+     -58,   -58,   -58,     8,   -58,   -58,   106,   -58,   108,   109,
+      73,   116,   126,   132,   138,   -58,   -58,   -58,   118,   -58,
+     -58,   -58,   -58,   -58,   -58,   119,    54,   144,   -58,   -58,
+     -58,   -58,   -58,   -58,     8,     8,     8,     8,     8,   124,
+     130,   -58,   -58,   -58,   -58,   -58,   -58,   133,   -58,   -58,
+     -58,   -58,   -58,   -58,    63,     4,    15,   140,   173,    25,
+     -58,    60,   143,   150,   182,   -58,   -58,   115,   152,    70,
+     115,   -58,   105,   -58
 };
 
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+static const yytype_int8 yydefact[] =
 {
        2,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     3,     4,     6,     7,     8,     9,     0,     0,
@@ -593,207 +649,154 @@ static const yytype_uint8 yydefact[] =
        0,     0,     0,     0,     0,     1,     5,    17,    18,    19,
       20,    21,    22,     0,    37,    36,     0,    31,     0,     0,
        0,     0,     0,     0,     0,    46,    47,    48,     0,    49,
-      50,    51,    52,    53,     0,     0,     0,    40,    41,    44,
-      45,    42,    43,     0,     0,     0,     0,     0,     0,     0,
-      24,    25,    26,    27,    28,    29,     0,    10,    38,    32,
-      33,    34,    35,    39,     0,     0,     0,    13,     0,    16,
-       0,     0,     0,    11,    15,    30,     0,     0,     0,     0,
-      14,     0,    12
+      50,    51,    52,    53,    54,     0,     0,     0,    40,    41,
+      44,    45,    42,    43,     0,     0,     0,     0,     0,     0,
+       0,    24,    25,    26,    27,    28,    29,     0,    10,    38,
+      32,    33,    34,    35,    39,     0,     0,     0,    13,     0,
+      16,     0,     0,     0,    11,    15,    30,     0,     0,     0,
+       0,    14,     0,    12
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+     -58,   -58,   -57,   -12,   -58,   -58,   -58,   -58,   -58,   -58,
+     -58,   -58,   -58,   -58,   -58,   -26,   107,   162,   -58,   -58,
+     -58
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,    11,    12,    13,    14,    15,    16,    17,    18,    19,
-      20,    21,    22,    23,    24,    46,    47,    48,    77,    58,
-      64
+       0,    11,    12,    13,    14,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,    24,    46,    47,    48,    78,    58,
+      65
 };
 
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-#define YYPACT_NINF -55
-static const yytype_int16 yypact[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
 {
-     113,   -13,    -3,    11,    41,    57,    66,    85,   100,   107,
-     -21,   137,   113,   -55,   -55,   -55,   -55,   -55,   104,   110,
-     112,   120,   138,   139,   -55,     6,     6,     6,     6,     6,
-       6,     6,   158,   142,     6,   -55,   -55,   -55,   -55,   -55,
-     -55,   -55,   -55,     6,   -55,   -55,   105,   -55,   116,   117,
-      28,    54,    62,    72,   114,   -55,   -55,   -55,   143,   -55,
-     -55,   -55,   -55,   -55,   144,    18,   124,   -55,   -55,   -55,
-     -55,   -55,   -55,     6,     6,     6,     6,     6,   145,   146,
-     -55,   -55,   -55,   -55,   -55,   -55,   141,   -55,   -55,   -55,
-     -55,   -55,   -55,   135,     4,    15,   147,   177,    25,   -55,
-      59,   148,   149,   178,   -55,   -55,   113,   152,    69,   113,
-     -55,   103,   -55
+      36,    50,    51,    52,    53,    54,    25,     1,    66,     2,
+       3,     4,     5,     6,     7,     8,     9,    67,     1,    26,
+       2,     3,     4,     5,     6,     7,     8,     9,     1,    27,
+       2,     3,     4,     5,     6,     7,     8,     9,    99,   101,
+      98,    43,    28,    10,    55,    56,    57,    44,    45,    29,
+     109,   100,    94,   112,    10,    59,    60,    61,    62,    63,
+      64,   104,    30,     1,    10,     2,     3,     4,     5,     6,
+       7,     8,     9,     1,    31,     2,     3,     4,     5,     6,
+       7,     8,     9,    74,    75,    76,    77,    36,    32,    36,
+      33,    88,    74,    75,    76,    77,   105,    36,    35,    10,
+      36,    37,    74,    75,    76,    77,   111,    81,     1,    10,
+       2,     3,     4,     5,     6,     7,     8,     9,     1,    34,
+       2,     3,     4,     5,     6,     7,     8,     9,    68,    69,
+      70,    71,    72,    73,    38,    74,    75,    76,    77,    39,
+      40,   113,    79,    80,    10,    74,    75,    76,    77,    41,
+      82,    42,    86,    87,    10,    74,    75,    76,    77,    95,
+      83,    74,    75,    76,    77,    96,    84,    74,    75,    76,
+      77,    97,    85,    74,    75,    76,    77,   103,    89,   102,
+     106,    90,    91,    92,    93,   107,   108,   110,    49
 };
 
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int16 yypgoto[] =
+static const yytype_int8 yycheck[] =
 {
-     -55,   -55,   -54,   -12,   -55,   -55,   -55,   -55,   -55,   -55,
-     -55,   -55,   -55,   -55,   -55,   -26,    94,   161,   -55,   -55,
-     -55
+      12,    27,    28,    29,    30,    31,    33,     3,    34,     5,
+       6,     7,     8,     9,    10,    11,    12,    43,     3,    33,
+       5,     6,     7,     8,     9,    10,    11,    12,     3,    33,
+       5,     6,     7,     8,     9,    10,    11,    12,    95,    96,
+      36,    33,    33,    39,    13,    14,    15,    39,    40,    33,
+     107,    36,    78,   110,    39,    16,    17,    18,    19,    20,
+      21,    36,    33,     3,    39,     5,     6,     7,     8,     9,
+      10,    11,    12,     3,    33,     5,     6,     7,     8,     9,
+      10,    11,    12,    29,    30,    31,    32,    99,    33,   101,
+      33,    37,    29,    30,    31,    32,    36,   109,     0,    39,
+     112,    37,    29,    30,    31,    32,    36,    34,     3,    39,
+       5,     6,     7,     8,     9,    10,    11,    12,     3,    28,
+       5,     6,     7,     8,     9,    10,    11,    12,    22,    23,
+      24,    25,    26,    27,    37,    29,    30,    31,    32,    37,
+      37,    36,    34,    34,    39,    29,    30,    31,    32,    37,
+      34,    37,    34,    34,    39,    29,    30,    31,    32,    35,
+      34,    29,    30,    31,    32,    35,    34,    29,    30,    31,
+      32,    38,    34,    29,    30,    31,    32,     4,    34,    39,
+      37,    74,    75,    76,    77,    35,     4,    35,    26
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-      36,    50,    51,    52,    53,    54,    34,     1,    65,     2,
-       3,     4,     5,     6,     7,     8,     9,    66,     1,    25,
-       2,     3,     4,     5,     6,     7,     8,     9,     1,    26,
-       2,     3,     4,     5,     6,     7,     8,     9,    43,    97,
-      98,   100,    10,    27,    44,    45,    73,    74,    75,    76,
-      99,    93,   108,    10,    87,   111,    73,    74,    75,    76,
-     103,    80,     1,    10,     2,     3,     4,     5,     6,     7,
-       8,     9,     1,    28,     2,     3,     4,     5,     6,     7,
-       8,     9,    73,    74,    75,    76,    36,    81,    36,    29,
-      73,    74,    75,    76,   104,    82,    36,    10,    30,    36,
-      73,    74,    75,    76,   110,    83,     1,    10,     2,     3,
-       4,     5,     6,     7,     8,     9,     1,    31,     2,     3,
-       4,     5,     6,     7,     8,     9,    67,    68,    69,    70,
-      71,    72,    32,    73,    74,    75,    76,    35,   112,    33,
-      37,    10,    73,    74,    75,    76,    38,    84,    39,    78,
-      79,    10,    73,    74,    75,    76,    40,    88,    59,    60,
-      61,    62,    63,    73,    74,    75,    76,    89,    90,    91,
-      92,    55,    56,    57,    41,    42,    85,    86,    96,    94,
-      95,   102,   107,   106,   105,   101,   109,    49
+       0,     3,     5,     6,     7,     8,     9,    10,    11,    12,
+      39,    42,    43,    44,    45,    46,    47,    48,    49,    50,
+      51,    52,    53,    54,    55,    33,    33,    33,    33,    33,
+      33,    33,    33,    33,    28,     0,    44,    37,    37,    37,
+      37,    37,    37,    33,    39,    40,    56,    57,    58,    58,
+      56,    56,    56,    56,    56,    13,    14,    15,    60,    16,
+      17,    18,    19,    20,    21,    61,    56,    56,    22,    23,
+      24,    25,    26,    27,    29,    30,    31,    32,    59,    34,
+      34,    34,    34,    34,    34,    34,    34,    34,    37,    34,
+      57,    57,    57,    57,    56,    35,    35,    38,    36,    43,
+      36,    43,    39,     4,    36,    36,    37,    35,     4,    43,
+      35,    36,    43,    36
 };
 
-static const yytype_uint8 yycheck[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-      12,    27,    28,    29,    30,    31,    27,     3,    34,     5,
-       6,     7,     8,     9,    10,    11,    12,    43,     3,    32,
-       5,     6,     7,     8,     9,    10,    11,    12,     3,    32,
-       5,     6,     7,     8,     9,    10,    11,    12,    32,    35,
-      94,    95,    38,    32,    38,    39,    28,    29,    30,    31,
-      35,    77,   106,    38,    36,   109,    28,    29,    30,    31,
-      35,    33,     3,    38,     5,     6,     7,     8,     9,    10,
-      11,    12,     3,    32,     5,     6,     7,     8,     9,    10,
-      11,    12,    28,    29,    30,    31,    98,    33,   100,    32,
-      28,    29,    30,    31,    35,    33,   108,    38,    32,   111,
-      28,    29,    30,    31,    35,    33,     3,    38,     5,     6,
-       7,     8,     9,    10,    11,    12,     3,    32,     5,     6,
-       7,     8,     9,    10,    11,    12,    21,    22,    23,    24,
-      25,    26,    32,    28,    29,    30,    31,     0,    35,    32,
-      36,    38,    28,    29,    30,    31,    36,    33,    36,    33,
-      33,    38,    28,    29,    30,    31,    36,    33,    16,    17,
-      18,    19,    20,    28,    29,    30,    31,    73,    74,    75,
-      76,    13,    14,    15,    36,    36,    33,    33,    37,    34,
-      34,     4,     4,    34,    36,    38,    34,    26
+       0,    41,    42,    42,    43,    43,    44,    44,    44,    44,
+      45,    46,    46,    46,    46,    47,    47,    48,    48,    48,
+      48,    48,    48,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    56,    56,    56,    56,    57,    57,    57,    58,
+      59,    59,    59,    59,    59,    59,    60,    60,    60,    61,
+      61,    61,    61,    61,    61
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
-       0,     3,     5,     6,     7,     8,     9,    10,    11,    12,
-      38,    41,    42,    43,    44,    45,    46,    47,    48,    49,
-      50,    51,    52,    53,    54,    32,    32,    32,    32,    32,
-      32,    32,    32,    32,    27,     0,    43,    36,    36,    36,
-      36,    36,    36,    32,    38,    39,    55,    56,    57,    57,
-      55,    55,    55,    55,    55,    13,    14,    15,    59,    16,
-      17,    18,    19,    20,    60,    55,    55,    21,    22,    23,
-      24,    25,    26,    28,    29,    30,    31,    58,    33,    33,
-      33,    33,    33,    33,    33,    33,    33,    36,    33,    56,
-      56,    56,    56,    55,    34,    34,    37,    35,    42,    35,
-      42,    38,     4,    35,    35,    36,    34,     4,    42,    34,
-      35,    42,    35
+       0,     2,     0,     1,     1,     2,     1,     1,     1,     1,
+       4,     7,    11,     6,    10,     7,     6,     2,     2,     2,
+       2,     2,     2,     1,     4,     4,     4,     4,     4,     4,
+       7,     1,     3,     3,     3,     3,     1,     1,     3,     3,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
 
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
+enum { YYENOMEM = -2 };
 
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-#define YYFAIL		goto yyerrlab
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)					\
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    {								\
-      yychar = (Token);						\
-      yylval = (Value);						\
-      yytoken = YYTRANSLATE (yychar);				\
-      YYPOPSTACK (1);						\
-      goto yybackup;						\
-    }								\
-  else								\
-    {								\
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
-   If N is 0, then set CURRENT to the empty location which ends
-   the previous symbol: RHS[0] (always defined).  */
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-#ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)				\
-    do									\
-      if (YYID (N))                                                    \
-	{								\
-	  (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;	\
-	  (Current).first_column = YYRHSLOC (Rhs, 1).first_column;	\
-	  (Current).last_line    = YYRHSLOC (Rhs, N).last_line;		\
-	  (Current).last_column  = YYRHSLOC (Rhs, N).last_column;	\
-	}								\
-      else								\
-	{								\
-	  (Current).first_line   = (Current).last_line   =		\
-	    YYRHSLOC (Rhs, 0).last_line;				\
-	  (Current).first_column = (Current).last_column =		\
-	    YYRHSLOC (Rhs, 0).last_column;				\
-	}								\
-    while (YYID (0))
-#endif
-
-
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
-
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
-#  define YY_LOCATION_PRINT(File, Loc)			\
-     fprintf (File, "%d.%d-%d.%d",			\
-	      (Loc).first_line, (Loc).first_column,	\
-	      (Loc).last_line,  (Loc).last_column)
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (program, scanner, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
-
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex ()
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -803,80 +806,60 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, program, scanner); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, RodeoProgram *program, void *scanner)
 {
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (program);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, RodeoProgram *program, void *scanner)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, program, scanner);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -884,80 +867,68 @@ yy_symbol_print (yyoutput, yytype, yyvaluep)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *bottom, yytype_int16 *top)
-#else
 static void
-yy_stack_print (bottom, top)
-    yytype_int16 *bottom;
-    yytype_int16 *top;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
-  for (; bottom <= top; ++bottom)
-    YYFPRINTF (stderr, " %d", *bottom);
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule)
-#else
-static void
-yy_reduce_print (yyvsp, yyrule)
-    YYSTYPE *yyvsp;
-    int yyrule;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, RodeoProgram *program, void *scanner)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
-      fprintf (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       );
-      fprintf (stderr, "\n");
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], program, scanner);
+      YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, program, scanner); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -972,478 +943,227 @@ int yydebug;
 # define YYMAXDEPTH 10000
 #endif
 
-
 
-#if YYERROR_VERBOSE
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
 
-  if (! yyres)
-    return yystrlen (yystr);
 
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error (char *yyresult, int yystate, int yychar)
-{
-  int yyn = yypact[yystate];
-
-  if (! (YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
-    {
-      int yytype = YYTRANSLATE (yychar);
-      YYSIZE_T yysize0 = yytnamerr (0, yytname[yytype]);
-      YYSIZE_T yysize = yysize0;
-      YYSIZE_T yysize1;
-      int yysize_overflow = 0;
-      enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-      char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-      int yyx;
-
-# if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-# endif
-      char *yyfmt;
-      char const *yyf;
-      static char const yyunexpected[] = "syntax error, unexpected %s";
-      static char const yyexpecting[] = ", expecting %s";
-      static char const yyor[] = " or %s";
-      char yyformat[sizeof yyunexpected
-		    + sizeof yyexpecting - 1
-		    + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2)
-		       * (sizeof yyor - 1))];
-      char const *yyprefix = yyexpecting;
-
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-	 YYCHECK.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
-
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yycount = 1;
-
-      yyarg[0] = yytname[yytype];
-      yyfmt = yystpcpy (yyformat, yyunexpected);
-
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-	if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
-	  {
-	    if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-	      {
-		yycount = 1;
-		yysize = yysize0;
-		yyformat[sizeof yyunexpected - 1] = '\0';
-		break;
-	      }
-	    yyarg[yycount++] = yytname[yyx];
-	    yysize1 = yysize + yytnamerr (0, yytname[yyx]);
-	    yysize_overflow |= (yysize1 < yysize);
-	    yysize = yysize1;
-	    yyfmt = yystpcpy (yyfmt, yyprefix);
-	    yyprefix = yyor;
-	  }
-
-      yyf = YY_(yyformat);
-      yysize1 = yysize + yystrlen (yyf);
-      yysize_overflow |= (yysize1 < yysize);
-      yysize = yysize1;
-
-      if (yysize_overflow)
-	return YYSIZE_MAXIMUM;
-
-      if (yyresult)
-	{
-	  /* Avoid sprintf, as that infringes on the user's name space.
-	     Don't have undefined behavior even if the translation
-	     produced a string with the wrong number of "%s"s.  */
-	  char *yyp = yyresult;
-	  int yyi = 0;
-	  while ((*yyp = *yyf) != '\0')
-	    {
-	      if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
-		{
-		  yyp += yytnamerr (yyp, yyarg[yyi++]);
-		  yyf += 2;
-		}
-	      else
-		{
-		  yyp++;
-		  yyf++;
-		}
-	    }
-	}
-      return yysize;
-    }
-}
-#endif /* YYERROR_VERBOSE */
-
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
-#else
-static void
-yydestruct (yymsg, yytype, yyvaluep)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, RodeoProgram *program, void *scanner)
 {
-  YYUSE (yyvaluep);
-
+  YY_USE (yyvaluep);
+  YY_USE (program);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-  switch (yytype)
-    {
-
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
-
 
-/* Prevent warnings from -Wmissing-prototypes.  */
 
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
 
 
 
-/* The look-ahead symbol.  */
-int yychar;
-
-/* The semantic value of the look-ahead symbol.  */
-YYSTYPE yylval;
-
-/* Number of syntax errors so far.  */
-int yynerrs;
-
-
 
 /*----------.
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
 int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void)
-#else
-int
-yyparse ()
-
-#endif
-#endif
+yyparse (RodeoProgram *program, void *scanner)
 {
-  
-  int yystate;
-  int yyn;
-  int yyresult;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
-  /* Look-ahead token as an internal (translated) token number.  */
-  int yytoken = 0;
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+/* Lookahead token kind.  */
+int yychar;
 
-  /* Three stacks and their tools:
-     `yyss': related to states,
-     `yyvs': related to semantic values,
-     `yyls': related to locations.
 
-     Refer to the stacks thru separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
 
-  /* The state stack.  */
-  yytype_int16 yyssa[YYINITDEPTH];
-  yytype_int16 *yyss = yyssa;
-  yytype_int16 *yyssp;
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-  /* The semantic value stack.  */
-  YYSTYPE yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs = yyvsa;
-  YYSTYPE *yyvsp;
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-  YYSIZE_T yystacksize = YYINITDEPTH;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
 
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY;		/* Cause a token to be read.  */
-
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-
-  yyssp = yyss;
-  yyvsp = yyvs;
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss);
-	YYSTACK_RELOCATE (yyvs);
-
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
-     look-ahead token if we need one and don't already have one.  */
+     lookahead token if we need one and don't already have one.  */
 
-  /* First try to decide what to do without reference to look-ahead token.  */
+  /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
-  /* Not known => get a look-ahead token if don't already have one.  */
+  /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid look-ahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, scanner);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1458,30 +1178,26 @@ yybackup:
   yyn = yytable[yyn];
   if (yyn <= 0)
     {
-      if (yyn == 0 || yyn == YYTABLE_NINF)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
   /* Count tokens shifted since error; after three, turn off error
      status.  */
   if (yyerrstatus)
     yyerrstatus--;
 
-  /* Shift the look-ahead token.  */
+  /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token unless it is eof.  */
-  if (yychar != YYEOF)
-    yychar = YYEMPTY;
-
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1496,14 +1212,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1516,426 +1232,453 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 56 "parser.y"
-    {
-        root_program = NULL;
-        (yyval.stmt_list) = NULL;
-    ;}
-    break;
-
-  case 3:
-#line 60 "parser.y"
-    {
-        root_program = (yyvsp[(1) - (1)].stmt_list);
-        (yyval.stmt_list) = (yyvsp[(1) - (1)].stmt_list);
-    ;}
-    break;
-
-  case 4:
-#line 67 "parser.y"
-    {
-        (yyval.stmt_list) = (yyvsp[(1) - (1)].stmt);
-    ;}
+  case 2: /* program: %empty  */
+#line 70 "parser.y"
+                {
+        program->statements = NULL;
+        (yyval.stmt) = NULL;
+    }
+#line 1242 "parser.tab.c"
     break;
 
-  case 5:
-#line 70 "parser.y"
-    {
-        if ((yyvsp[(1) - (2)].stmt_list)) {
-            append_statement(&(yyvsp[(1) - (2)].stmt_list), (yyvsp[(2) - (2)].stmt));
-            (yyval.stmt_list) = (yyvsp[(1) - (2)].stmt_list);
-        } else {
-            (yyval.stmt_list) = (yyvsp[(2) - (2)].stmt);
-        }
-    ;}
+  case 3: /* program: statement_list  */
+#line 74 "parser.y"
+                     {
+        program->statements = (yyvsp[0].stmt_list).head;
+        (yyval.stmt) = (yyvsp[0].stmt_list).head;
+    }
+#line 1251 "parser.tab.c"
     break;
 
-  case 6:
+  case 4: /* statement_list: statement  */
 #line 81 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].stmt); ;}
+              {
+        (yyval.stmt_list).head = (yyval.stmt_list).tail = NULL;
+        append_statement(&(yyval.stmt_list), (yyvsp[0].stmt));
+    }
+#line 1260 "parser.tab.c"
     break;
 
-  case 7:
-#line 82 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].stmt); ;}
+  case 5: /* statement_list: statement_list statement  */
+#line 85 "parser.y"
+                               {
+        (yyval.stmt_list) = (yyvsp[-1].stmt_list);
+        append_statement(&(yyval.stmt_list), (yyvsp[0].stmt));
+    }
+#line 1269 "parser.tab.c"
     break;
 
-  case 8:
-#line 83 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].stmt); ;}
+  case 6: /* statement: assignment  */
+#line 92 "parser.y"
+               { (yyval.stmt) = (yyvsp[0].stmt); }
+#line 1275 "parser.tab.c"
     break;
 
-  case 9:
-#line 84 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].stmt); ;}
+  case 7: /* statement: if_stmt  */
+#line 93 "parser.y"
+              { (yyval.stmt) = (yyvsp[0].stmt); }
+#line 1281 "parser.tab.c"
     break;
 
-  case 10:
-#line 88 "parser.y"
-    {
-        (yyval.stmt) = create_assignment((yyvsp[(1) - (4)].string), (yyvsp[(3) - (4)].expr));
-        free((yyvsp[(1) - (4)].string));
-    ;}
+  case 8: /* statement: while_stmt  */
+#line 94 "parser.y"
+                 { (yyval.stmt) = (yyvsp[0].stmt); }
+#line 1287 "parser.tab.c"
     break;
 
-  case 11:
+  case 9: /* statement: command  */
 #line 95 "parser.y"
-    {
-        (yyval.stmt) = create_if_stmt((yyvsp[(3) - (7)].cond), (yyvsp[(6) - (7)].stmt_list), NULL);
-    ;}
+              { (yyval.stmt) = (yyvsp[0].stmt); }
+#line 1293 "parser.tab.c"
     break;
 
-  case 12:
-#line 98 "parser.y"
-    {
-        (yyval.stmt) = create_if_stmt((yyvsp[(3) - (11)].cond), (yyvsp[(6) - (11)].stmt_list), (yyvsp[(10) - (11)].stmt_list));
-    ;}
+  case 10: /* assignment: IDENTIFIER ASSIGN expression SEMICOLON  */
+#line 99 "parser.y"
+                                           {
+        (yyval.stmt) = create_assignment(&program->arena, (yyvsp[-3].symbol), (yyvsp[-1].expr));
+    }
+#line 1301 "parser.tab.c"
     break;
 
-  case 13:
-#line 101 "parser.y"
-    {
-        (yyval.stmt) = create_if_stmt((yyvsp[(3) - (6)].cond), NULL, NULL);
-    ;}
+  case 11: /* if_stmt: IF LPAREN condition RPAREN LBRACE statement_list RBRACE  */
+#line 105 "parser.y"
+                                                            {
+        (yyval.stmt) = create_if_stmt(&program->arena, (yyvsp[-4].cond), (yyvsp[-1].stmt_list).head, NULL);
+    }
+#line 1309 "parser.tab.c"
     break;
 
-  case 14:
-#line 104 "parser.y"
-    {
-        (yyval.stmt) = create_if_stmt((yyvsp[(3) - (10)].cond), NULL, (yyvsp[(9) - (10)].stmt_list));
-    ;}
+  case 12: /* if_stmt: IF LPAREN condition RPAREN LBRACE statement_list RBRACE ELSE LBRACE statement_list RBRACE  */
+#line 108 "parser.y"
+                                                                                                {
+        (yyval.stmt) = create_if_stmt(&program->arena, (yyvsp[-8].cond), (yyvsp[-5].stmt_list).head, (yyvsp[-1].stmt_list).head);
+    }
+#line 1317 "parser.tab.c"
     break;
 
-  case 15:
-#line 110 "parser.y"
-    {
-        (yyval.stmt) = create_while_stmt((yyvsp[(3) - (7)].cond), (yyvsp[(6) - (7)].stmt_list));
-    ;}
+  case 13: /* if_stmt: IF LPAREN condition RPAREN LBRACE RBRACE  */
+#line 111 "parser.y"
+                                               {
+        (yyval.stmt) = create_if_stmt(&program->arena, (yyvsp[-3].cond), NULL, NULL);
+    }
+#line 1325 "parser.tab.c"
     break;
 
-  case 16:
-#line 113 "parser.y"
-    {
-        (yyval.stmt) = create_while_stmt((yyvsp[(3) - (6)].cond), NULL);
-    ;}
+  case 14: /* if_stmt: IF LPAREN condition RPAREN LBRACE RBRACE ELSE LBRACE statement_list RBRACE  */
+#line 114 "parser.y"
+                                                                                 {
+        (yyval.stmt) = create_if_stmt(&program->arena, (yyvsp[-7].cond), NULL, (yyvsp[-1].stmt_list).head);
+    }
+#line 1333 "parser.tab.c"
     break;
 
-  case 17:
-#line 119 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (2)].stmt); ;}
+  case 15: /* while_stmt: WHILE LPAREN condition RPAREN LBRACE statement_list RBRACE  */
+#line 120 "parser.y"
+                                                               {
+        (yyval.stmt) = create_while_stmt(&program->arena, (yyvsp[-4].cond), (yyvsp[-1].stmt_list).head);
+    }
+#line 1341 "parser.tab.c"
     break;
 
-  case 18:
-#line 120 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (2)].stmt); ;}
+  case 16: /* while_stmt: WHILE LPAREN condition RPAREN LBRACE RBRACE  */
+#line 123 "parser.y"
+                                                  {
+        (yyval.stmt) = create_while_stmt(&program->arena, (yyvsp[-3].cond), NULL);
+    }
+#line 1349 "parser.tab.c"
     break;
 
-  case 19:
-#line 121 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (2)].stmt); ;}
+  case 17: /* command: speed_cmd SEMICOLON  */
+#line 129 "parser.y"
+                        { (yyval.stmt) = (yyvsp[-1].stmt); }
+#line 1355 "parser.tab.c"
     break;
 
-  case 20:
-#line 122 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (2)].stmt); ;}
+  case 18: /* command: torque_cmd SEMICOLON  */
+#line 130 "parser.y"
+                           { (yyval.stmt) = (yyvsp[-1].stmt); }
+#line 1361 "parser.tab.c"
     break;
 
-  case 21:
-#line 123 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (2)].stmt); ;}
+  case 19: /* command: yaw_cmd SEMICOLON  */
+#line 131 "parser.y"
+                        { (yyval.stmt) = (yyvsp[-1].stmt); }
+#line 1367 "parser.tab.c"
     break;
 
-  case 22:
-#line 124 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (2)].stmt); ;}
+  case 20: /* command: brake_cmd SEMICOLON  */
+#line 132 "parser.y"
+                          { (yyval.stmt) = (yyvsp[-1].stmt); }
+#line 1373 "parser.tab.c"
     break;
 
-  case 23:
-#line 125 "parser.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].stmt); ;}
+  case 21: /* command: wait_cmd SEMICOLON  */
+#line 133 "parser.y"
+                         { (yyval.stmt) = (yyvsp[-1].stmt); }
+#line 1379 "parser.tab.c"
     break;
 
-  case 24:
-#line 129 "parser.y"
-    {
-        (yyval.stmt) = create_speed_cmd((yyvsp[(3) - (4)].expr));
-    ;}
+  case 22: /* command: pattern_cmd SEMICOLON  */
+#line 134 "parser.y"
+                            { (yyval.stmt) = (yyvsp[-1].stmt); }
+#line 1385 "parser.tab.c"
     break;
 
-  case 25:
+  case 23: /* command: sensor_cmd  */
 #line 135 "parser.y"
-    {
-        (yyval.stmt) = create_torque_cmd((yyvsp[(3) - (4)].expr));
-    ;}
+                 { (yyval.stmt) = (yyvsp[0].stmt); }
+#line 1391 "parser.tab.c"
     break;
 
-  case 26:
-#line 141 "parser.y"
-    {
-        (yyval.stmt) = create_yaw_cmd((yyvsp[(3) - (4)].expr));
-    ;}
+  case 24: /* speed_cmd: SPEED LPAREN expression RPAREN  */
+#line 139 "parser.y"
+                                   {
+        (yyval.stmt) = create_speed_cmd(&program->arena, (yyvsp[-1].expr));
+    }
+#line 1399 "parser.tab.c"
     break;
 
-  case 27:
-#line 147 "parser.y"
-    {
-        (yyval.stmt) = create_brake_cmd((yyvsp[(3) - (4)].expr));
-    ;}
+  case 25: /* torque_cmd: TORQUE LPAREN expression RPAREN  */
+#line 145 "parser.y"
+                                    {
+        (yyval.stmt) = create_torque_cmd(&program->arena, (yyvsp[-1].expr));
+    }
+#line 1407 "parser.tab.c"
     break;
 
-  case 28:
-#line 153 "parser.y"
-    {
-        (yyval.stmt) = create_wait_cmd((yyvsp[(3) - (4)].expr));
-    ;}
+  case 26: /* yaw_cmd: YAW LPAREN expression RPAREN  */
+#line 151 "parser.y"
+                                 {
+        (yyval.stmt) = create_yaw_cmd(&program->arena, (yyvsp[-1].expr));
+    }
+#line 1415 "parser.tab.c"
     break;
 
-  case 29:
-#line 159 "parser.y"
-    {
-        (yyval.stmt) = create_pattern_cmd((yyvsp[(3) - (4)].pattern));
-    ;}
+  case 27: /* brake_cmd: BRAKE LPAREN expression RPAREN  */
+#line 157 "parser.y"
+                                   {
+        (yyval.stmt) = create_brake_cmd(&program->arena, (yyvsp[-1].expr));
+    }
+#line 1423 "parser.tab.c"
     break;
 
-  case 30:
-#line 165 "parser.y"
-    {
-        (yyval.stmt) = create_sensor_read((yyvsp[(3) - (7)].sensor), (yyvsp[(6) - (7)].string));
-        free((yyvsp[(6) - (7)].string));
-    ;}
+  case 28: /* wait_cmd: WAIT LPAREN expression RPAREN  */
+#line 163 "parser.y"
+                                  {
+        (yyval.stmt) = create_wait_cmd(&program->arena, (yyvsp[-1].expr));
+    }
+#line 1431 "parser.tab.c"
     break;
 
-  case 31:
-#line 172 "parser.y"
-    {
-        (yyval.expr) = (yyvsp[(1) - (1)].expr);
-    ;}
+  case 29: /* pattern_cmd: PATTERN LPAREN mode RPAREN  */
+#line 169 "parser.y"
+                               {
+        (yyval.stmt) = create_pattern_cmd(&program->arena, (yyvsp[-1].pattern));
+    }
+#line 1439 "parser.tab.c"
     break;
 
-  case 32:
+  case 30: /* sensor_cmd: READ LPAREN sensor RPAREN ARROW IDENTIFIER SEMICOLON  */
 #line 175 "parser.y"
-    {
-        (yyval.expr) = create_binary_expr(OP_ADD, (yyvsp[(1) - (3)].expr), (yyvsp[(3) - (3)].expr));
-    ;}
-    break;
-
-  case 33:
-#line 178 "parser.y"
-    {
-        (yyval.expr) = create_binary_expr(OP_SUB, (yyvsp[(1) - (3)].expr), (yyvsp[(3) - (3)].expr));
-    ;}
+                                                         {
+        (yyval.stmt) = create_sensor_read(&program->arena, (yyvsp[-4].sensor), (yyvsp[-1].symbol));
+    }
+#line 1447 "parser.tab.c"
     break;
 
-  case 34:
+  case 31: /* expression: term  */
 #line 181 "parser.y"
-    {
-        (yyval.expr) = create_binary_expr(OP_MUL, (yyvsp[(1) - (3)].expr), (yyvsp[(3) - (3)].expr));
-    ;}
+         {
+        (yyval.expr) = (yyvsp[0].expr);
+    }
+#line 1455 "parser.tab.c"
     break;
 
-  case 35:
+  case 32: /* expression: expression PLUS term  */
 #line 184 "parser.y"
-    {
-        (yyval.expr) = create_binary_expr(OP_DIV, (yyvsp[(1) - (3)].expr), (yyvsp[(3) - (3)].expr));
-    ;}
+                           {
+        (yyval.expr) = create_binary_expr(&program->arena, OP_ADD, (yyvsp[-2].expr), (yyvsp[0].expr));
+    }
+#line 1463 "parser.tab.c"
     break;
 
-  case 36:
-#line 190 "parser.y"
-    {
-        (yyval.expr) = create_number_expr((yyvsp[(1) - (1)].number));
-    ;}
+  case 33: /* expression: expression MINUS term  */
+#line 187 "parser.y"
+                            {
+        (yyval.expr) = create_binary_expr(&program->arena, OP_SUB, (yyvsp[-2].expr), (yyvsp[0].expr));
+    }
+#line 1471 "parser.tab.c"
     break;
 
-  case 37:
-#line 193 "parser.y"
-    {
-        (yyval.expr) = create_identifier_expr((yyvsp[(1) - (1)].string));
-        free((yyvsp[(1) - (1)].string));
-    ;}
+  case 34: /* expression: expression MULT term  */
+#line 190 "parser.y"
+                           {
+        (yyval.expr) = create_binary_expr(&program->arena, OP_MUL, (yyvsp[-2].expr), (yyvsp[0].expr));
+    }
+#line 1479 "parser.tab.c"
     break;
 
-  case 38:
-#line 197 "parser.y"
-    {
-        (yyval.expr) = (yyvsp[(2) - (3)].expr);
-    ;}
+  case 35: /* expression: expression DIV term  */
+#line 193 "parser.y"
+                          {
+        (yyval.expr) = create_binary_expr(&program->arena, OP_DIV, (yyvsp[-2].expr), (yyvsp[0].expr));
+    }
+#line 1487 "parser.tab.c"
     break;
 
-  case 39:
-#line 203 "parser.y"
-    {
-        (yyval.cond) = create_condition((yyvsp[(2) - (3)].relop), (yyvsp[(1) - (3)].expr), (yyvsp[(3) - (3)].expr));
-    ;}
+  case 36: /* term: NUMBER  */
+#line 199 "parser.y"
+           {
+        (yyval.expr) = create_number_expr(&program->arena, (yyvsp[0].number));
+    }
+#line 1495 "parser.tab.c"
     break;
 
-  case 40:
-#line 209 "parser.y"
-    { (yyval.relop) = REL_EQ; ;}
+  case 37: /* term: IDENTIFIER  */
+#line 202 "parser.y"
+                 {
+        (yyval.expr) = create_identifier_expr(&program->arena, (yyvsp[0].symbol));
+    }
+#line 1503 "parser.tab.c"
     break;
 
-  case 41:
-#line 210 "parser.y"
-    { (yyval.relop) = REL_NE; ;}
+  case 38: /* term: LPAREN expression RPAREN  */
+#line 205 "parser.y"
+                               {
+        (yyval.expr) = (yyvsp[-1].expr);
+    }
+#line 1511 "parser.tab.c"
     break;
 
-  case 42:
+  case 39: /* condition: expression relop expression  */
 #line 211 "parser.y"
-    { (yyval.relop) = REL_GT; ;}
-    break;
-
-  case 43:
-#line 212 "parser.y"
-    { (yyval.relop) = REL_LT; ;}
-    break;
-
-  case 44:
-#line 213 "parser.y"
-    { (yyval.relop) = REL_GE; ;}
+                                {
+        (yyval.cond) = create_condition(&program->arena, (yyvsp[-1].relop), (yyvsp[-2].expr), (yyvsp[0].expr));
+    }
+#line 1519 "parser.tab.c"
     break;
 
-  case 45:
-#line 214 "parser.y"
-    { (yyval.relop) = REL_LE; ;}
+  case 40: /* relop: EQ  */
+#line 217 "parser.y"
+       { (yyval.relop) = REL_EQ; }
+#line 1525 "parser.tab.c"
     break;
 
-  case 46:
+  case 41: /* relop: NE  */
 #line 218 "parser.y"
-    { (yyval.pattern) = PATTERN_CALM; ;}
+         { (yyval.relop) = REL_NE; }
+#line 1531 "parser.tab.c"
     break;
 
-  case 47:
+  case 42: /* relop: GT  */
 #line 219 "parser.y"
-    { (yyval.pattern) = PATTERN_SWIRL; ;}
+         { (yyval.relop) = REL_GT; }
+#line 1537 "parser.tab.c"
     break;
 
-  case 48:
+  case 43: /* relop: LT  */
 #line 220 "parser.y"
-    { (yyval.pattern) = PATTERN_AGGRESSIVE; ;}
+         { (yyval.relop) = REL_LT; }
+#line 1543 "parser.tab.c"
     break;
 
-  case 49:
-#line 224 "parser.y"
-    { (yyval.sensor) = SENSOR_RIDER; ;}
+  case 44: /* relop: GE  */
+#line 221 "parser.y"
+         { (yyval.relop) = REL_GE; }
+#line 1549 "parser.tab.c"
     break;
 
-  case 50:
-#line 225 "parser.y"
-    { (yyval.sensor) = SENSOR_TILT; ;}
+  case 45: /* relop: LE  */
+#line 222 "parser.y"
+         { (yyval.relop) = REL_LE; }
+#line 1555 "parser.tab.c"
     break;
 
-  case 51:
+  case 46: /* mode: CALM  */
 #line 226 "parser.y"
-    { (yyval.sensor) = SENSOR_RPM; ;}
+         { (yyval.pattern) = PATTERN_CALM; }
+#line 1561 "parser.tab.c"
     break;
 
-  case 52:
+  case 47: /* mode: SWIRL  */
 #line 227 "parser.y"
-    { (yyval.sensor) = SENSOR_EMERGENCY; ;}
+            { (yyval.pattern) = PATTERN_SWIRL; }
+#line 1567 "parser.tab.c"
     break;
 
-  case 53:
+  case 48: /* mode: AGGRESSIVE  */
 #line 228 "parser.y"
-    { (yyval.sensor) = SENSOR_TIME_MS; ;}
+                 { (yyval.pattern) = PATTERN_AGGRESSIVE; }
+#line 1573 "parser.tab.c"
+    break;
+
+  case 49: /* sensor: RIDER  */
+#line 232 "parser.y"
+          { (yyval.sensor) = SENSOR_RIDER; }
+#line 1579 "parser.tab.c"
+    break;
+
+  case 50: /* sensor: TILT  */
+#line 233 "parser.y"
+           { (yyval.sensor) = SENSOR_TILT; }
+#line 1585 "parser.tab.c"
+    break;
+
+  case 51: /* sensor: RPM  */
+#line 234 "parser.y"
+          { (yyval.sensor) = SENSOR_RPM; }
+#line 1591 "parser.tab.c"
+    break;
+
+  case 52: /* sensor: EMERGENCY  */
+#line 235 "parser.y"
+                { (yyval.sensor) = SENSOR_EMERGENCY; }
+#line 1597 "parser.tab.c"
+    break;
+
+  case 53: /* sensor: TIME_MS  */
+#line 236 "parser.y"
+              { (yyval.sensor) = SENSOR_TIME_MS; }
+#line 1603 "parser.tab.c"
+    break;
+
+  case 54: /* sensor: TIME_US  */
+#line 237 "parser.y"
+              { (yyval.sensor) = SENSOR_TIME_US; }
+#line 1609 "parser.tab.c"
     break;
 
 
-/* Line 1267 of yacc.c.  */
-#line 1846 "parser.tab.c"
+#line 1613 "parser.tab.c"
+
       default: break;
     }
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
-#else
-      {
-	YYSIZE_T yysize = yysyntax_error (0, yystate, yychar);
-	if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
-	  {
-	    YYSIZE_T yyalloc = 2 * yysize;
-	    if (! (yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-	      yyalloc = YYSTACK_ALLOC_MAXIMUM;
-	    if (yymsg != yymsgbuf)
-	      YYSTACK_FREE (yymsg);
-	    yymsg = (char *) YYSTACK_ALLOC (yyalloc);
-	    if (yymsg)
-	      yymsg_alloc = yyalloc;
-	    else
-	      {
-		yymsg = yymsgbuf;
-		yymsg_alloc = sizeof yymsgbuf;
-	      }
-	  }
-
-	if (0 < yysize && yysize <= yymsg_alloc)
-	  {
-	    (void) yysyntax_error (yymsg, yystate, yychar);
-	    yyerror (yymsg);
-	  }
-	else
-	  {
-	    yyerror (YY_("syntax error"));
-	    if (yysize != 0)
-	      goto yyexhaustedlab;
-	  }
-      }
-#endif
+      yyerror (program, scanner, YY_("syntax error"));
     }
 
-
-
   if (yyerrstatus == 3)
     {
-      /* If just tried and failed to reuse look-ahead token after an
-	 error, discard it.  */
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, program, scanner);
+          yychar = YYEMPTY;
+        }
     }
 
-  /* Else will try to reuse look-ahead token after shifting the error
+  /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
@@ -1944,14 +1687,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -1964,42 +1706,42 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
-      if (yyn != YYPACT_NINF)
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, program, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2010,92 +1752,400 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#ifndef yyoverflow
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
+  yyerror (program, scanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-yyreturn:
-  if (yychar != YYEOF && yychar != YYEMPTY)
-     yydestruct ("Cleanup: discarding lookahead",
-		 yytoken, &yylval);
-  /* Do not reclaim the symbols of the rule which action triggered
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, program, scanner);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, program, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
+
+  return yyresult;
+}
+
+#line 240 "parser.y"
+
+
+void yyerror(RodeoProgram *program, void *scanner, const char *s) {
+    (void)scanner;
+    rodeo_add_diagnostic(program, DIAG_SYNTAX, "%s", s);
 }
 
+// The benchmarks link the parser without the command-line driver
+#ifndef RODEO_NO_MAIN
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--trace=off|summary|full] [--trace-file=PATH] "
+                    "[--telemetry=RIDE.rtl] [--channel=NAME] [--channel-sync] [--clock=virtual|real] "
+                    "[--clock-source=coarse|monotonic|tsc] [--clock-cache] [--jit] [--scanner=flex|fast] [--no-optimize] "
+                    "[--fuse-profile=TRACE] [--dump-ast] [--compile=OUT.rbc] [--emit-c[=OUT.c]] "
+                    "[file.rodeo|file.rbc]\n"
+                    "       %s --convert-telemetry=OUT.rtl ride.csv\n"
+                    "       %s --batch [--threads=N] [--instances=N] [--lockstep] [--scanner=flex|fast] "
+                    "[--no-optimize] files-or-dirs...\n", prog, prog, prog);
+}
+
+// Parses and compiles (or maps) every program on the pool, then runs all instances on it.
+static int run_batch(char **paths, int path_count, int threads, int instances,
+                     ScannerKind scanner, int optimize, unsigned int fuse, int lockstep) {
+    int source_count;
+    char **sources = batch_collect_sources(paths, path_count, &source_count);
+    BatchProgram *programs = (BatchProgram *)calloc(source_count + 1, sizeof(BatchProgram));
+    BatchJob *jobs = (BatchJob *)calloc((size_t)source_count * instances + 1, sizeof(BatchJob));
+    int job_count = 0;
+    int failed = 0;
+
+    for (int i = 0; i < source_count; i++) {
+        programs[i].path = sources[i];
+    }
+    batch_load(programs, source_count, threads, scanner, optimize, fuse);
+
+    for (int i = 0; i < source_count; i++) {
+        Bytecode *code = programs[i].code;
+        if (programs[i].program) {
+            rodeo_print_diagnostics(stderr, programs[i].program);
+        }
+        if (programs[i].program && programs[i].program->failed) {
+            fprintf(stderr, "%s: parsing failed\n", sources[i]);
+        }
+        if (!code) failed++;
+
+        for (int k = 0; k < instances; k++) {
+            BatchJob *job = &jobs[job_count++];
+            job->path = sources[i];
+            job->seed = instances > 1 ? (unsigned int)(k + 1) : 0;
+            job->code = code;
+            job->status = code ? 0 : -1;
+        }
+    }
+
+    if (lockstep) {
+        // The CSV goes to stdout; say which sensor kernel this CPU got
+        fprintf(stderr, "Lockstep sensor kernel: %s\n", fleet_kernel_name());
+        batch_run_lockstep(jobs, job_count, threads);
+    } else {
+        batch_run(jobs, job_count, threads);
+    }
+    batch_print_results(stdout, jobs, job_count);
 
-#line 231 "parser.y"
+    for (int i = 0; i < source_count; i++) {
+        free_bytecode(programs[i].code);
+        rodeo_free_program(programs[i].program);
+    }
+    free(programs);
+    free(jobs);
+    batch_free_sources(sources, source_count);
+    return failed ? 1 : 0;
+}
 
+// How run_program sets up the VM
+typedef struct {
+    TraceLevel trace_level;
+    const char *trace_file;
+    const char *telemetry_path;
+    const char *channel_name;
+    int channel_sync;
+    TimeMode time_mode;
+    ClockSource clock_source;
+    int clock_source_set;   // otherwise picked from the sensors the program reads
+    int clock_cache;
+    Engine engine;
+} RunOptions;
+
+static int run_program(Bytecode *code, const RunOptions *options) {
+    Telemetry *telemetry = NULL;
+    Channel *channel = NULL;
+    if (options->telemetry_path && !(telemetry = telemetry_open(options->telemetry_path))) {
+        return 1;
+    }
+    if (options->channel_name && !(channel = channel_open(options->channel_name))) {
+        return 1;
+    }
 
-void yyerror(const char *s) {
-    fprintf(stderr, "Syntax error at line %d: %s\n", line_num, s);
+    VMContext vm;
+    ReplayBackend replay;
+    ChannelBackend driver;
+    int status = 0;
+    vm_init(&vm, options->trace_level);
+    vm.time_mode = options->time_mode;
+    // The coarse clock only moves once per tick, which is useless in microseconds
+    ClockSource source = options->clock_source;
+    if (!options->clock_source_set && bytecode_reads_sensor(code, SENSOR_TIME_US)) {
+        source = RODEO_CLOCK_MONOTONIC;
+    }
+    rodeo_clock_init(&vm.clock, source, options->clock_cache);
+    if (telemetry) {
+        backend_replay_init(&replay, telemetry);
+        status = vm_set_backend(&vm, &backend_replay, &replay);
+    } else if (channel) {
+        backend_channel_init(&driver, channel, options->channel_sync);
+        status = vm_set_backend(&vm, &backend_channel, &driver);
+    }
+    vm.engine = options->engine;
+    if (status == 0 && options->trace_file) {
+        status = trace_open_file(&vm.trace, options->trace_file);
+    }
+    if (status == 0) status = vm_run_bytecode(&vm, code);
+    if (status == 0) vm_print_state(&vm);
+    if (channel && vm.backend) backend_channel_detach(&driver);
+
+    vm_cleanup(&vm);
+    telemetry_close(telemetry);
+    channel_close(channel);
+    return status == 0 ? 0 : 1;
 }
 
 int main(int argc, char **argv) {
-    if (argc > 1) {
-        FILE *file = fopen(argv[1], "r");
-        if (!file) {
-            perror(argv[1]);
+    RunOptions run = {TRACE_FULL, NULL, NULL, NULL, 0, TIME_VIRTUAL, RODEO_CLOCK_COARSE, 0, 0,
+                      ENGINE_INTERPRETER};
+    const char *telemetry_out = NULL;
+    const char *image_path = NULL;
+    const char *emit_path = NULL;
+    int emit_c = 0;
+    const char *source = NULL;
+    ScannerKind scanner = SCANNER_FLEX;
+    int optimize = 1;
+    unsigned int fuse = FUSE_ALL;
+    const char *fuse_profile = NULL;
+    int dump = 0;
+    int batch = 0;
+    int lockstep = 0;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int instances = 1;
+    char **positional = (char **)malloc(sizeof(char *) * argc);
+    int positional_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--trace=", 8) == 0) {
+            if (trace_parse_level(argv[i] + 8, &run.trace_level) != 0) {
+                usage(argv[0]);
+                free(positional);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--trace-file=", 13) == 0) {
+            run.trace_file = argv[i] + 13;
+        } else if (strcmp(argv[i], "--clock=virtual") == 0) {
+            run.time_mode = TIME_VIRTUAL;
+        } else if (strcmp(argv[i], "--clock=real") == 0) {
+            run.time_mode = TIME_REAL;
+        } else if (strncmp(argv[i], "--clock-source=", 15) == 0) {
+            if (rodeo_clock_parse_source(argv[i] + 15, &run.clock_source) != 0) {
+                usage(argv[0]);
+                free(positional);
+                return 1;
+            }
+            run.clock_source_set = 1;
+        } else if (strcmp(argv[i], "--clock-cache") == 0) {
+            run.clock_cache = 1;
+        } else if (strcmp(argv[i], "--jit") == 0) {
+            run.engine = ENGINE_JIT;
+        } else if (strcmp(argv[i], "--scanner=flex") == 0) {
+            scanner = SCANNER_FLEX;
+        } else if (strcmp(argv[i], "--scanner=fast") == 0) {
+            scanner = SCANNER_FAST;
+        } else if (strncmp(argv[i], "--telemetry=", 12) == 0) {
+            run.telemetry_path = argv[i] + 12;
+        } else if (strncmp(argv[i], "--channel=", 10) == 0) {
+            run.channel_name = argv[i] + 10;
+        } else if (strcmp(argv[i], "--channel-sync") == 0) {
+            run.channel_sync = 1;
+        } else if (strncmp(argv[i], "--convert-telemetry=", 20) == 0) {
+            telemetry_out = argv[i] + 20;
+        } else if (strncmp(argv[i], "--compile=", 10) == 0) {
+            image_path = argv[i] + 10;
+        } else if (strcmp(argv[i], "--emit-c") == 0) {
+            emit_c = 1;
+        } else if (strncmp(argv[i], "--emit-c=", 9) == 0) {
+            emit_c = 1;
+            emit_path = argv[i] + 9;
+        } else if (strcmp(argv[i], "--no-optimize") == 0) {
+            optimize = 0;
+        } else if (strncmp(argv[i], "--fuse-profile=", 15) == 0) {
+            fuse_profile = argv[i] + 15;
+        } else if (strcmp(argv[i], "--dump-ast") == 0) {
+            dump = 1;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batch = 1;
+        } else if (strcmp(argv[i], "--lockstep") == 0) {
+            lockstep = 1;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--instances=", 12) == 0) {
+            instances = atoi(argv[i] + 12);
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            usage(argv[0]);
+            free(positional);
             return 1;
+        } else {
+            source = argv[i];
+            positional[positional_count++] = argv[i];
         }
-        yyin = file;
     }
 
-    printf("=== Rodeo VM - Lexical and Syntactic Analysis ===\n");
-    
-    if (yyparse() == 0) {
-        printf("✓ Parsing completed successfully!\n");
-        
-        if (root_program) {
-            // Initialize and run VM
-            VMContext vm;
-            vm_init(&vm);
-            vm_execute(&vm, root_program);
-            vm_print_state(&vm);
-            
-            // Cleanup
-            vm_cleanup(&vm);
-            free_ast(root_program);
-        } else {
-            printf("Warning: Empty program\n");
+    // Only fuse the superinstructions whose statement pairs are common in the trace
+    if (fuse_profile) {
+        PairProfile profile;
+        if (fuse_mine_trace(fuse_profile, &profile) != 0) {
+            free(positional);
+            return 1;
+        }
+        fuse_print_pairs(stderr, &profile, 10);
+        fuse = fuse_select(&profile);
+    }
+    if (!optimize) fuse = 0;
+
+    if (telemetry_out) {
+        free(positional);
+        if (!source) {
+            usage(argv[0]);
+            return 1;
         }
+        return telemetry_convert_csv(source, telemetry_out) == 0 ? 0 : 1;
+    }
+
+    if (run.trace_file && run.trace_level != TRACE_FULL) {
+        fprintf(stderr, "Error: --trace-file needs --trace=full\n");
+        free(positional);
+        return 1;
+    }
+
+    if (run.telemetry_path && run.channel_name) {
+        fprintf(stderr, "Error: --telemetry cannot be used with --channel\n");
+        free(positional);
+        return 1;
+    }
+
+    if (batch) {
+        if (run.telemetry_path || run.channel_name || run.trace_file) {
+            fprintf(stderr, "Error: --telemetry, --channel and --trace-file cannot be used "
+                            "with --batch\n");
+            free(positional);
+            return 1;
+        }
+        if (positional_count == 0 || instances < 1) {
+            usage(argv[0]);
+            free(positional);
+            return 1;
+        }
+        int status = run_batch(positional, positional_count, threads, instances, scanner,
+                               optimize, fuse, lockstep);
+        free(positional);
+        return status;
+    }
+    free(positional);
+
+    // Generated C written to stdout must not be mixed with progress messages
+    int verbose = run.trace_level != TRACE_OFF && !(emit_c && !emit_path);
+    if (source && image_probe(source)) {
+        Bytecode *code = image_load(source);
+        if (!code) return 1;
+        int status = run_program(code, &run);
+        free_bytecode(code);
+        return status;
+    }
+
+    FILE *input = stdin;
+    if (source) {
+        input = fopen(source, "r");
+        if (!input) {
+            perror(source);
+            return 1;
+        }
+    }
+
+    if (verbose) printf("=== Rodeo VM - Lexical and Syntactic Analysis ===\n");
+    
+    // The fast scanner maps named files instead of reading them through stdio
+    RodeoProgram *program;
+    if (source && scanner == SCANNER_FAST) {
+        fclose(input);
+        program = rodeo_parse_file(source, SCANNER_FAST);
     } else {
+        program = rodeo_parse_stream(input, scanner);
+        if (input != stdin) fclose(input);
+    }
+    rodeo_print_diagnostics(stderr, program);
+
+    if (program->failed) {
         printf("✗ Parsing failed with errors\n");
+        rodeo_free_program(program);
         return 1;
     }
 
-    return 0;
-}
+    if (verbose) printf("✓ Parsing completed successfully!\n");
+        
+    int status = 0;
+    if (program->statements || image_path || emit_c) {
+        // Resolve, optimize and compile to bytecode
+        Bytecode *code = rodeo_compile(program, optimize, fuse);
+        if (!code) {
+            rodeo_free_program(program);
+            return 1;
+        }
 
+        if (dump) {
+            dump_ast(stdout, program->statements);
+        } else if (emit_c) {
+            FILE *out = emit_path ? fopen(emit_path, "w") : stdout;
+            if (!out) {
+                perror(emit_path);
+                status = 1;
+            } else {
+                status = emit_c_program(out, program->statements, code,
+                                        source ? source : "stdin") == 0 ? 0 : 1;
+                if (out != stdout) fclose(out);
+                if (status == 0 && verbose) printf("✓ Generated %s\n", emit_path);
+            }
+        } else if (image_path) {
+            status = image_write(image_path, code) == 0 ? 0 : 1;
+            if (status == 0 && verbose) printf("✓ Compiled to %s\n", image_path);
+        } else {
+            status = run_program(code, &run);
+        }
+        free_bytecode(code);
+    } else if (verbose) {
+        printf("Warning: Empty program\n");
+    }
+
+    rodeo_free_program(program);
+    return status;
+}
+#endif
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,115 +31,106 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     IF = 258,
-     ELSE = 259,
-     WHILE = 260,
-     SPEED = 261,
-     TORQUE = 262,
-     YAW = 263,
-     BRAKE = 264,
-     WAIT = 265,
-     PATTERN = 266,
-     READ = 267,
-     CALM = 268,
-     SWIRL = 269,
-     AGGRESSIVE = 270,
-     RIDER = 271,
-     TILT = 272,
-     RPM = 273,
-     EMERGENCY = 274,
-     TIME_MS = 275,
-     EQ = 276,
-     NE = 277,
-     GE = 278,
-     LE = 279,
-     GT = 280,
-     LT = 281,
-     ASSIGN = 282,
-     PLUS = 283,
-     MINUS = 284,
-     MULT = 285,
-     DIV = 286,
-     LPAREN = 287,
-     RPAREN = 288,
-     LBRACE = 289,
-     RBRACE = 290,
-     SEMICOLON = 291,
-     ARROW = 292,
-     IDENTIFIER = 293,
-     NUMBER = 294
-   };
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_TAB_H_INCLUDED
+# define YY_YY_PARSER_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
 #endif
-/* Tokens.  */
-#define IF 258
-#define ELSE 259
-#define WHILE 260
-#define SPEED 261
-#define TORQUE 262
-#define YAW 263
-#define BRAKE 264
-#define WAIT 265
-#define PATTERN 266
-#define READ 267
-#define CALM 268
-#define SWIRL 269
-#define AGGRESSIVE 270
-#define RIDER 271
-#define TILT 272
-#define RPM 273
-#define EMERGENCY 274
-#define TIME_MS 275
-#define EQ 276
-#define NE 277
-#define GE 278
-#define LE 279
-#define GT 280
-#define LT 281
-#define ASSIGN 282
-#define PLUS 283
-#define MINUS 284
-#define MULT 285
-#define DIV 286
-#define LPAREN 287
-#define RPAREN 288
-#define LBRACE 289
-#define RBRACE 290
-#define SEMICOLON 291
-#define ARROW 292
-#define IDENTIFIER 293
-#define NUMBER 294
+/* "%code requires" blocks.  */
+#line 16 "parser.y"
 
+#include "frontend.h"
 
+#line 53 "parser.tab.h"
 
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IF = 258,                      /* IF  */
+    ELSE = 259,                    /* ELSE  */
+    WHILE = 260,                   /* WHILE  */
+    SPEED = 261,                   /* SPEED  */
+    TORQUE = 262,                  /* TORQUE  */
+    YAW = 263,                     /* YAW  */
+    BRAKE = 264,                   /* BRAKE  */
+    WAIT = 265,                    /* WAIT  */
+    PATTERN = 266,                 /* PATTERN  */
+    READ = 267,                    /* READ  */
+    CALM = 268,                    /* CALM  */
+    SWIRL = 269,                   /* SWIRL  */
+    AGGRESSIVE = 270,              /* AGGRESSIVE  */
+    RIDER = 271,                   /* RIDER  */
+    TILT = 272,                    /* TILT  */
+    RPM = 273,                     /* RPM  */
+    EMERGENCY = 274,               /* EMERGENCY  */
+    TIME_MS = 275,                 /* TIME_MS  */
+    TIME_US = 276,                 /* TIME_US  */
+    EQ = 277,                      /* EQ  */
+    NE = 278,                      /* NE  */
+    GE = 279,                      /* GE  */
+    LE = 280,                      /* LE  */
+    GT = 281,                      /* GT  */
+    LT = 282,                      /* LT  */
+    ASSIGN = 283,                  /* ASSIGN  */
+    PLUS = 284,                    /* PLUS  */
+    MINUS = 285,                   /* MINUS  */
+    MULT = 286,                    /* MULT  */
+    DIV = 287,                     /* DIV  */
+    LPAREN = 288,                  /* LPAREN  */
+    RPAREN = 289,                  /* RPAREN  */
+    LBRACE = 290,                  /* LBRACE  */
+    RBRACE = 291,                  /* RBRACE  */
+    SEMICOLON = 292,               /* SEMICOLON  */
+    ARROW = 293,                   /* ARROW  */
+    IDENTIFIER = 294,              /* IDENTIFIER  */
+    NUMBER = 295                   /* NUMBER  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 18 "parser.y"
+union YYSTYPE
 {
+#line 31 "parser.y"
+
     int number;
-    char *string;
+    Symbol *symbol;
     Expression *expr;
     Condition *cond;
     ASTNode *stmt;
-    ASTNode *stmt_list;
+    StatementList stmt_list;
     BinaryOp binop;
     RelOp relop;
     Pattern pattern;
     SensorType sensor;
-}
-/* Line 1529 of yacc.c.  */
-#line 140 "parser.tab.h"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+
+#line 123 "parser.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE yylval;
 
+
+
+int yyparse (RodeoProgram *program, void *scanner);
+
+
+#endif /* !YY_YY_PARSER_TAB_H_INCLUDED  */
@@ -4,24 +4,37 @@
 #include <string.h>
 #include "ast.h"
 #include "vm.h"
+#include "batch.h"
+#include "fleet.h"
+#include "image.h"
+#include "fuse.h"
+#include "emit_c.h"
+#include "backend.h"
+#include <unistd.h>
+%}
 
-extern int yylex();
-extern int yyparse();
-extern FILE *yyin;
-extern int line_num;
+%code requires {
+#include "frontend.h"
+}
 
-void yyerror(const char *s);
+%code {
+// Dispatches to the Flex or the hand-written scanner (frontend.c)
+int rodeo_lex(YYSTYPE *lvalp, void *scanner);
+#define yylex rodeo_lex
+void yyerror(RodeoProgram *program, void *scanner, const char *s);
+}
 
-ASTNode *root_program = NULL;
-%}
+%define api.pure full
+%parse-param {RodeoProgram *program} {void *scanner}
+%lex-param {void *scanner}
 
 %union {
     int number;
-    char *string;
+    Symbol *symbol;
     Expression *expr;
     Condition *cond;
     ASTNode *stmt;
-    ASTNode *stmt_list;
+    StatementList stmt_list;
     BinaryOp binop;
     RelOp relop;
     Pattern pattern;
@@ -31,18 +44,19 @@ ASTNode *root_program = NULL;
 %token IF ELSE WHILE
 %token SPEED TORQUE YAW BRAKE WAIT PATTERN READ
 %token CALM SWIRL AGGRESSIVE
-%token RIDER TILT RPM EMERGENCY TIME_MS
+%token RIDER TILT RPM EMERGENCY TIME_MS TIME_US
 %token EQ NE GE LE GT LT
 %token ASSIGN PLUS MINUS MULT DIV
 %token LPAREN RPAREN LBRACE RBRACE SEMICOLON ARROW
-%token <string> IDENTIFIER
+%token <symbol> IDENTIFIER
 %token <number> NUMBER
 
 %type <expr> expression term
 %type <cond> condition
 %type <stmt> statement assignment if_stmt while_stmt command
 %type <stmt> speed_cmd torque_cmd yaw_cmd brake_cmd wait_cmd pattern_cmd sensor_cmd
-%type <stmt_list> statement_list program
+%type <stmt_list> statement_list
+%type <stmt> program
 %type <relop> relop
 %type <pattern> mode
 %type <sensor> sensor
@@ -54,26 +68,23 @@ ASTNode *root_program = NULL;
 
 program:
     /* empty */ {
-        root_program = NULL;
+        program->statements = NULL;
         $$ = NULL;
     }
     | statement_list {
-        root_program = $1;
-        $$ = $1;
+        program->statements = $1.head;
+        $$ = $1.head;
     }
     ;
 
 statement_list:
     statement {
-        $$ = $1;
+        $$.head = $$.tail = NULL;
+        append_statement(&$$, $1);
     }
     | statement_list statement {
-        if ($1) {
-            append_statement(&$1, $2);
-            $$ = $1;
-        } else {
-            $$ = $2;
-        }
+        $$ = $1;
+        append_statement(&$$, $2);
     }
     ;
 
@@ -86,32 +97,31 @@ statement:
 
 assignment:
     IDENTIFIER ASSIGN expression SEMICOLON {
-        $$ = create_assignment($1, $3);
-        free($1);
+        $$ = create_assignment(&program->arena, $1, $3);
     }
     ;
 
 if_stmt:
     IF LPAREN condition RPAREN LBRACE statement_list RBRACE {
-        $$ = create_if_stmt($3, $6, NULL);
+        $$ = create_if_stmt(&program->arena, $3, $6.head, NULL);
     }
     | IF LPAREN condition RPAREN LBRACE statement_list RBRACE ELSE LBRACE statement_list RBRACE {
-        $$ = create_if_stmt($3, $6, $10);
+        $$ = create_if_stmt(&program->arena, $3, $6.head, $10.head);
     }
     | IF LPAREN condition RPAREN LBRACE RBRACE {
-        $$ = create_if_stmt($3, NULL, NULL);
+        $$ = create_if_stmt(&program->arena, $3, NULL, NULL);
     }
     | IF LPAREN condition RPAREN LBRACE RBRACE ELSE LBRACE statement_list RBRACE {
-        $$ = create_if_stmt($3, NULL, $9);
+        $$ = create_if_stmt(&program->arena, $3, NULL, $9.head);
     }
     ;
 
 while_stmt:
     WHILE LPAREN condition RPAREN LBRACE statement_list RBRACE {
-        $$ = create_while_stmt($3, $6);
+        $$ = create_while_stmt(&program->arena, $3, $6.head);
     }
     | WHILE LPAREN condition RPAREN LBRACE RBRACE {
-        $$ = create_while_stmt($3, NULL);
+        $$ = create_while_stmt(&program->arena, $3, NULL);
     }
     ;
 
@@ -127,44 +137,43 @@ command:
 
 speed_cmd:
     SPEED LPAREN expression RPAREN {
-        $$ = create_speed_cmd($3);
+        $$ = create_speed_cmd(&program->arena, $3);
     }
     ;
 
 torque_cmd:
     TORQUE LPAREN expression RPAREN {
-        $$ = create_torque_cmd($3);
+        $$ = create_torque_cmd(&program->arena, $3);
     }
     ;
 
 yaw_cmd:
     YAW LPAREN expression RPAREN {
-        $$ = create_yaw_cmd($3);
+        $$ = create_yaw_cmd(&program->arena, $3);
     }
     ;
 
 brake_cmd:
     BRAKE LPAREN expression RPAREN {
-        $$ = create_brake_cmd($3);
+        $$ = create_brake_cmd(&program->arena, $3);
     }
     ;
 
 wait_cmd:
     WAIT LPAREN expression RPAREN {
-        $$ = create_wait_cmd($3);
+        $$ = create_wait_cmd(&program->arena, $3);
     }
     ;
 
 pattern_cmd:
     PATTERN LPAREN mode RPAREN {
-        $$ = create_pattern_cmd($3);
+        $$ = create_pattern_cmd(&program->arena, $3);
     }
     ;
 
 sensor_cmd:
     READ LPAREN sensor RPAREN ARROW IDENTIFIER SEMICOLON {
-        $$ = create_sensor_read($3, $6);
-        free($6);
+        $$ = create_sensor_read(&program->arena, $3, $6);
     }
     ;
 
@@ -173,26 +182,25 @@ expression:
         $$ = $1;
     }
     | expression PLUS term {
-        $$ = create_binary_expr(OP_ADD, $1, $3);
+        $$ = create_binary_expr(&program->arena, OP_ADD, $1, $3);
     }
     | expression MINUS term {
-        $$ = create_binary_expr(OP_SUB, $1, $3);
+        $$ = create_binary_expr(&program->arena, OP_SUB, $1, $3);
     }
     | expression MULT term {
-        $$ = create_binary_expr(OP_MUL, $1, $3);
+        $$ = create_binary_expr(&program->arena, OP_MUL, $1, $3);
     }
     | expression DIV term {
-        $$ = create_binary_expr(OP_DIV, $1, $3);
+        $$ = create_binary_expr(&program->arena, OP_DIV, $1, $3);
     }
     ;
 
 term:
     NUMBER {
-        $$ = create_number_expr($1);
+        $$ = create_number_expr(&program->arena, $1);
     }
     | IDENTIFIER {
-        $$ = create_identifier_expr($1);
-        free($1);
+        $$ = create_identifier_expr(&program->arena, $1);
     }
     | LPAREN expression RPAREN {
         $$ = $2;
@@ -201,7 +209,7 @@ term:
 
 condition:
     expression relop expression {
-        $$ = create_condition($2, $1, $3);
+        $$ = create_condition(&program->arena, $2, $1, $3);
     }
     ;
 
@@ -226,46 +234,352 @@ sensor:
     | RPM { $$ = SENSOR_RPM; }
     | EMERGENCY { $$ = SENSOR_EMERGENCY; }
     | TIME_MS { $$ = SENSOR_TIME_MS; }
+    | TIME_US { $$ = SENSOR_TIME_US; }
     ;
 
 %%
 
-void yyerror(const char *s) {
-    fprintf(stderr, "Syntax error at line %d: %s\n", line_num, s);
+void yyerror(RodeoProgram *program, void *scanner, const char *s) {
+    (void)scanner;
+    rodeo_add_diagnostic(program, DIAG_SYNTAX, "%s", s);
+}
+
+// The benchmarks link the parser without the command-line driver
+#ifndef RODEO_NO_MAIN
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--trace=off|summary|full] [--trace-file=PATH] "
+                    "[--telemetry=RIDE.rtl] [--channel=NAME] [--channel-sync] [--clock=virtual|real] "
+                    "[--clock-source=coarse|monotonic|tsc] [--clock-cache] [--jit] [--scanner=flex|fast] [--no-optimize] "
+                    "[--fuse-profile=TRACE] [--dump-ast] [--compile=OUT.rbc] [--emit-c[=OUT.c]] "
+                    "[file.rodeo|file.rbc]\n"
+                    "       %s --convert-telemetry=OUT.rtl ride.csv\n"
+                    "       %s --batch [--threads=N] [--instances=N] [--lockstep] [--scanner=flex|fast] "
+                    "[--no-optimize] files-or-dirs...\n", prog, prog, prog);
+}
+
+// Parses and compiles (or maps) every program on the pool, then runs all instances on it.
+static int run_batch(char **paths, int path_count, int threads, int instances,
+                     ScannerKind scanner, int optimize, unsigned int fuse, int lockstep) {
+    int source_count;
+    char **sources = batch_collect_sources(paths, path_count, &source_count);
+    BatchProgram *programs = (BatchProgram *)calloc(source_count + 1, sizeof(BatchProgram));
+    BatchJob *jobs = (BatchJob *)calloc((size_t)source_count * instances + 1, sizeof(BatchJob));
+    int job_count = 0;
+    int failed = 0;
+
+    for (int i = 0; i < source_count; i++) {
+        programs[i].path = sources[i];
+    }
+    batch_load(programs, source_count, threads, scanner, optimize, fuse);
+
+    for (int i = 0; i < source_count; i++) {
+        Bytecode *code = programs[i].code;
+        if (programs[i].program) {
+            rodeo_print_diagnostics(stderr, programs[i].program);
+        }
+        if (programs[i].program && programs[i].program->failed) {
+            fprintf(stderr, "%s: parsing failed\n", sources[i]);
+        }
+        if (!code) failed++;
+
+        for (int k = 0; k < instances; k++) {
+            BatchJob *job = &jobs[job_count++];
+            job->path = sources[i];
+            job->seed = instances > 1 ? (unsigned int)(k + 1) : 0;
+            job->code = code;
+            job->status = code ? 0 : -1;
+        }
+    }
+
+    if (lockstep) {
+        // The CSV goes to stdout; say which sensor kernel this CPU got
+        fprintf(stderr, "Lockstep sensor kernel: %s\n", fleet_kernel_name());
+        batch_run_lockstep(jobs, job_count, threads);
+    } else {
+        batch_run(jobs, job_count, threads);
+    }
+    batch_print_results(stdout, jobs, job_count);
+
+    for (int i = 0; i < source_count; i++) {
+        free_bytecode(programs[i].code);
+        rodeo_free_program(programs[i].program);
+    }
+    free(programs);
+    free(jobs);
+    batch_free_sources(sources, source_count);
+    return failed ? 1 : 0;
+}
+
+// How run_program sets up the VM
+typedef struct {
+    TraceLevel trace_level;
+    const char *trace_file;
+    const char *telemetry_path;
+    const char *channel_name;
+    int channel_sync;
+    TimeMode time_mode;
+    ClockSource clock_source;
+    int clock_source_set;   // otherwise picked from the sensors the program reads
+    int clock_cache;
+    Engine engine;
+} RunOptions;
+
+static int run_program(Bytecode *code, const RunOptions *options) {
+    Telemetry *telemetry = NULL;
+    Channel *channel = NULL;
+    if (options->telemetry_path && !(telemetry = telemetry_open(options->telemetry_path))) {
+        return 1;
+    }
+    if (options->channel_name && !(channel = channel_open(options->channel_name))) {
+        return 1;
+    }
+
+    VMContext vm;
+    ReplayBackend replay;
+    ChannelBackend driver;
+    int status = 0;
+    vm_init(&vm, options->trace_level);
+    vm.time_mode = options->time_mode;
+    // The coarse clock only moves once per tick, which is useless in microseconds
+    ClockSource source = options->clock_source;
+    if (!options->clock_source_set && bytecode_reads_sensor(code, SENSOR_TIME_US)) {
+        source = RODEO_CLOCK_MONOTONIC;
+    }
+    rodeo_clock_init(&vm.clock, source, options->clock_cache);
+    if (telemetry) {
+        backend_replay_init(&replay, telemetry);
+        status = vm_set_backend(&vm, &backend_replay, &replay);
+    } else if (channel) {
+        backend_channel_init(&driver, channel, options->channel_sync);
+        status = vm_set_backend(&vm, &backend_channel, &driver);
+    }
+    vm.engine = options->engine;
+    if (status == 0 && options->trace_file) {
+        status = trace_open_file(&vm.trace, options->trace_file);
+    }
+    if (status == 0) status = vm_run_bytecode(&vm, code);
+    if (status == 0) vm_print_state(&vm);
+    if (channel && vm.backend) backend_channel_detach(&driver);
+
+    vm_cleanup(&vm);
+    telemetry_close(telemetry);
+    channel_close(channel);
+    return status == 0 ? 0 : 1;
 }
 
 int main(int argc, char **argv) {
-    if (argc > 1) {
-        FILE *file = fopen(argv[1], "r");
-        if (!file) {
-            perror(argv[1]);
+    RunOptions run = {TRACE_FULL, NULL, NULL, NULL, 0, TIME_VIRTUAL, RODEO_CLOCK_COARSE, 0, 0,
+                      ENGINE_INTERPRETER};
+    const char *telemetry_out = NULL;
+    const char *image_path = NULL;
+    const char *emit_path = NULL;
+    int emit_c = 0;
+    const char *source = NULL;
+    ScannerKind scanner = SCANNER_FLEX;
+    int optimize = 1;
+    unsigned int fuse = FUSE_ALL;
+    const char *fuse_profile = NULL;
+    int dump = 0;
+    int batch = 0;
+    int lockstep = 0;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int instances = 1;
+    char **positional = (char **)malloc(sizeof(char *) * argc);
+    int positional_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--trace=", 8) == 0) {
+            if (trace_parse_level(argv[i] + 8, &run.trace_level) != 0) {
+                usage(argv[0]);
+                free(positional);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--trace-file=", 13) == 0) {
+            run.trace_file = argv[i] + 13;
+        } else if (strcmp(argv[i], "--clock=virtual") == 0) {
+            run.time_mode = TIME_VIRTUAL;
+        } else if (strcmp(argv[i], "--clock=real") == 0) {
+            run.time_mode = TIME_REAL;
+        } else if (strncmp(argv[i], "--clock-source=", 15) == 0) {
+            if (rodeo_clock_parse_source(argv[i] + 15, &run.clock_source) != 0) {
+                usage(argv[0]);
+                free(positional);
+                return 1;
+            }
+            run.clock_source_set = 1;
+        } else if (strcmp(argv[i], "--clock-cache") == 0) {
+            run.clock_cache = 1;
+        } else if (strcmp(argv[i], "--jit") == 0) {
+            run.engine = ENGINE_JIT;
+        } else if (strcmp(argv[i], "--scanner=flex") == 0) {
+            scanner = SCANNER_FLEX;
+        } else if (strcmp(argv[i], "--scanner=fast") == 0) {
+            scanner = SCANNER_FAST;
+        } else if (strncmp(argv[i], "--telemetry=", 12) == 0) {
+            run.telemetry_path = argv[i] + 12;
+        } else if (strncmp(argv[i], "--channel=", 10) == 0) {
+            run.channel_name = argv[i] + 10;
+        } else if (strcmp(argv[i], "--channel-sync") == 0) {
+            run.channel_sync = 1;
+        } else if (strncmp(argv[i], "--convert-telemetry=", 20) == 0) {
+            telemetry_out = argv[i] + 20;
+        } else if (strncmp(argv[i], "--compile=", 10) == 0) {
+            image_path = argv[i] + 10;
+        } else if (strcmp(argv[i], "--emit-c") == 0) {
+            emit_c = 1;
+        } else if (strncmp(argv[i], "--emit-c=", 9) == 0) {
+            emit_c = 1;
+            emit_path = argv[i] + 9;
+        } else if (strcmp(argv[i], "--no-optimize") == 0) {
+            optimize = 0;
+        } else if (strncmp(argv[i], "--fuse-profile=", 15) == 0) {
+            fuse_profile = argv[i] + 15;
+        } else if (strcmp(argv[i], "--dump-ast") == 0) {
+            dump = 1;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batch = 1;
+        } else if (strcmp(argv[i], "--lockstep") == 0) {
+            lockstep = 1;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--instances=", 12) == 0) {
+            instances = atoi(argv[i] + 12);
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            usage(argv[0]);
+            free(positional);
             return 1;
+        } else {
+            source = argv[i];
+            positional[positional_count++] = argv[i];
         }
-        yyin = file;
     }
 
-    printf("=== Rodeo VM - Lexical and Syntactic Analysis ===\n");
-    
-    if (yyparse() == 0) {
-        printf("✓ Parsing completed successfully!\n");
-        
-        if (root_program) {
-            // Initialize and run VM
-            VMContext vm;
-            vm_init(&vm);
-            vm_execute(&vm, root_program);
-            vm_print_state(&vm);
-            
-            // Cleanup
-            vm_cleanup(&vm);
-            free_ast(root_program);
-        } else {
-            printf("Warning: Empty program\n");
+    // Only fuse the superinstructions whose statement pairs are common in the trace
+    if (fuse_profile) {
+        PairProfile profile;
+        if (fuse_mine_trace(fuse_profile, &profile) != 0) {
+            free(positional);
+            return 1;
+        }
+        fuse_print_pairs(stderr, &profile, 10);
+        fuse = fuse_select(&profile);
+    }
+    if (!optimize) fuse = 0;
+
+    if (telemetry_out) {
+        free(positional);
+        if (!source) {
+            usage(argv[0]);
+            return 1;
+        }
+        return telemetry_convert_csv(source, telemetry_out) == 0 ? 0 : 1;
+    }
+
+    if (run.trace_file && run.trace_level != TRACE_FULL) {
+        fprintf(stderr, "Error: --trace-file needs --trace=full\n");
+        free(positional);
+        return 1;
+    }
+
+    if (run.telemetry_path && run.channel_name) {
+        fprintf(stderr, "Error: --telemetry cannot be used with --channel\n");
+        free(positional);
+        return 1;
+    }
+
+    if (batch) {
+        if (run.telemetry_path || run.channel_name || run.trace_file) {
+            fprintf(stderr, "Error: --telemetry, --channel and --trace-file cannot be used "
+                            "with --batch\n");
+            free(positional);
+            return 1;
+        }
+        if (positional_count == 0 || instances < 1) {
+            usage(argv[0]);
+            free(positional);
+            return 1;
         }
+        int status = run_batch(positional, positional_count, threads, instances, scanner,
+                               optimize, fuse, lockstep);
+        free(positional);
+        return status;
+    }
+    free(positional);
+
+    // Generated C written to stdout must not be mixed with progress messages
+    int verbose = run.trace_level != TRACE_OFF && !(emit_c && !emit_path);
+    if (source && image_probe(source)) {
+        Bytecode *code = image_load(source);
+        if (!code) return 1;
+        int status = run_program(code, &run);
+        free_bytecode(code);
+        return status;
+    }
+
+    FILE *input = stdin;
+    if (source) {
+        input = fopen(source, "r");
+        if (!input) {
+            perror(source);
+            return 1;
+        }
+    }
+
+    if (verbose) printf("=== Rodeo VM - Lexical and Syntactic Analysis ===\n");
+    
+    // The fast scanner maps named files instead of reading them through stdio
+    RodeoProgram *program;
+    if (source && scanner == SCANNER_FAST) {
+        fclose(input);
+        program = rodeo_parse_file(source, SCANNER_FAST);
     } else {
+        program = rodeo_parse_stream(input, scanner);
+        if (input != stdin) fclose(input);
+    }
+    rodeo_print_diagnostics(stderr, program);
+
+    if (program->failed) {
         printf("✗ Parsing failed with errors\n");
+        rodeo_free_program(program);
         return 1;
     }
 
-    return 0;
+    if (verbose) printf("✓ Parsing completed successfully!\n");
+        
+    int status = 0;
+    if (program->statements || image_path || emit_c) {
+        // Resolve, optimize and compile to bytecode
+        Bytecode *code = rodeo_compile(program, optimize, fuse);
+        if (!code) {
+            rodeo_free_program(program);
+            return 1;
+        }
+
+        if (dump) {
+            dump_ast(stdout, program->statements);
+        } else if (emit_c) {
+            FILE *out = emit_path ? fopen(emit_path, "w") : stdout;
+            if (!out) {
+                perror(emit_path);
+                status = 1;
+            } else {
+                status = emit_c_program(out, program->statements, code,
+                                        source ? source : "stdin") == 0 ? 0 : 1;
+                if (out != stdout) fclose(out);
+                if (status == 0 && verbose) printf("✓ Generated %s\n", emit_path);
+            }
+        } else if (image_path) {
+            status = image_write(image_path, code) == 0 ? 0 : 1;
+            if (status == 0 && verbose) printf("✓ Compiled to %s\n", image_path);
+        } else {
+            status = run_program(code, &run);
+        }
+        free_bytecode(code);
+    } else if (verbose) {
+        printf("Warning: Empty program\n");
+    }
+
+    rodeo_free_program(program);
+    return status;
 }
+#endif
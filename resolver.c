@@ -0,0 +1,134 @@
+#include "resolver.h"
+
+// Slots are handed out in resolution order, which fixes the order variables
+// are listed in; the symbol id only indexes the lookup.
+static int resolve_name(SymbolTable *symbols, Symbol *symbol) {
+    if (symbol->id >= symbols->slot_capacity) {
+        int capacity = symbols->slot_capacity ? symbols->slot_capacity : 16;
+        while (capacity <= symbol->id) capacity *= 2;
+
+        symbols->slots = (int *)realloc(symbols->slots, sizeof(int) * capacity);
+        for (int i = symbols->slot_capacity; i < capacity; i++) {
+            symbols->slots[i] = -1;
+        }
+        symbols->slot_capacity = capacity;
+    }
+
+    if (symbols->slots[symbol->id] >= 0) {
+        return symbols->slots[symbol->id];
+    }
+
+    if (symbols->count >= MAX_VARIABLES) {
+        fprintf(stderr, "Error: Maximum number of variables exceeded\n");
+        return -1;
+    }
+
+    if (symbols->count == symbols->capacity) {
+        symbols->capacity = symbols->capacity ? symbols->capacity * 2 : 16;
+        symbols->names = (const char **)realloc(symbols->names,
+                                                sizeof(const char *) * symbols->capacity);
+    }
+    symbols->names[symbols->count] = symbol->name;
+    symbols->slots[symbol->id] = symbols->count;
+    return symbols->count++;
+}
+
+static int resolve_expression(SymbolTable *symbols, Expression *expr) {
+    if (!expr) return 0;
+
+    switch (expr->type) {
+        case EXPR_NUMBER:
+            return 0;
+
+        case EXPR_IDENTIFIER:
+            expr->data.identifier.slot = resolve_name(symbols, expr->data.identifier.symbol);
+            return expr->data.identifier.slot < 0 ? -1 : 0;
+
+        case EXPR_BINARY_OP:
+            if (resolve_expression(symbols, expr->data.binary.left) < 0) return -1;
+            return resolve_expression(symbols, expr->data.binary.right);
+    }
+    return 0;
+}
+
+static int resolve_condition(SymbolTable *symbols, Condition *cond) {
+    if (!cond) return 0;
+
+    if (resolve_expression(symbols, cond->left) < 0) return -1;
+    return resolve_expression(symbols, cond->right);
+}
+
+static int resolve_list(SymbolTable *symbols, ASTNode *list);
+
+static int resolve_statement(SymbolTable *symbols, ASTNode *stmt) {
+    switch (stmt->type) {
+        case STMT_ASSIGNMENT:
+            if (resolve_expression(symbols, stmt->data.assignment.expr) < 0) return -1;
+            stmt->data.assignment.slot = resolve_name(symbols, stmt->data.assignment.var);
+            return stmt->data.assignment.slot < 0 ? -1 : 0;
+
+        case STMT_IF:
+            if (resolve_condition(symbols, stmt->data.if_stmt.condition) < 0) return -1;
+            if (resolve_list(symbols, stmt->data.if_stmt.then_block) < 0) return -1;
+            return resolve_list(symbols, stmt->data.if_stmt.else_block);
+
+        case STMT_WHILE:
+            if (resolve_condition(symbols, stmt->data.while_stmt.condition) < 0) return -1;
+            return resolve_list(symbols, stmt->data.while_stmt.body);
+
+        case STMT_SPEED:
+            return resolve_expression(symbols, stmt->data.speed_cmd.expr);
+
+        case STMT_TORQUE:
+            return resolve_expression(symbols, stmt->data.torque_cmd.expr);
+
+        case STMT_YAW:
+            return resolve_expression(symbols, stmt->data.yaw_cmd.expr);
+
+        case STMT_BRAKE:
+            return resolve_expression(symbols, stmt->data.brake_cmd.expr);
+
+        case STMT_WAIT:
+            return resolve_expression(symbols, stmt->data.wait_cmd.expr);
+
+        case STMT_PATTERN:
+            return 0;
+
+        case STMT_SENSOR_READ:
+            stmt->data.sensor_read.slot = resolve_name(symbols, stmt->data.sensor_read.var);
+            return stmt->data.sensor_read.slot < 0 ? -1 : 0;
+
+        case STMT_BLOCK:
+            for (int i = 0; i < stmt->data.block.count; i++) {
+                if (resolve_statement(symbols, stmt->data.block.statements[i]) < 0) return -1;
+            }
+            return 0;
+    }
+    return 0;
+}
+
+static int resolve_list(SymbolTable *symbols, ASTNode *list) {
+    for (ASTNode *current = list; current; current = current->next) {
+        if (resolve_statement(symbols, current) < 0) return -1;
+    }
+    return 0;
+}
+
+int resolve_program(ASTNode *program, SymbolTable *symbols) {
+    symbols->names = NULL;
+    symbols->count = 0;
+    symbols->capacity = 0;
+    symbols->slots = NULL;
+    symbols->slot_capacity = 0;
+    return resolve_list(symbols, program);
+}
+
+void free_symbols(SymbolTable *symbols) {
+    free(symbols->names);
+    symbols->names = NULL;
+    symbols->capacity = 0;
+    free(symbols->slots);
+    symbols->slots = NULL;
+    symbols->slot_capacity = 0;
+    symbols->count = 0;
+}
@@ -0,0 +1,21 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "ast.h"
+
+// Trace events record register slots in 16 bits
+#define MAX_VARIABLES 65536
+
+typedef struct {
+    const char **names; // by slot; interned, owned by the program arena
+    int count;
+    int capacity;
+
+    int *slots;         // slot of each symbol id, -1 until first seen
+    int slot_capacity;
+} SymbolTable;
+
+int resolve_program(ASTNode *program, SymbolTable *symbols);
+void free_symbols(SymbolTable *symbols);
+
+#endif
@@ -64,6 +64,201 @@ for test_info in "${tests[@]}"; do
     echo ""
 done
 
+# Every program must produce the same trace, final state and errors under these
+# options as under the interpreter with the Flex scanner
+variants=(
+    "--jit:JIT matches the interpreter"
+    "--scanner=fast:Fast scanner matches the Flex scanner"
+)
+
+for variant in "${variants[@]}"; do
+    IFS=':' read -r option description <<< "$variant"
+
+    # The JIT only exists on x86-64; elsewhere rodeo-vm falls back with a warning
+    if ./rodeo-vm --trace=off $option test.rodeo 2>&1 | grep -q "not available"; then
+        echo "(skipping $option: not available on this machine)"
+        echo ""
+        continue
+    fi
+
+    for file in test.rodeo examples/*.rodeo; do
+        ((total++))
+        echo "────────────────────────────────────────────────────────"
+        echo "Test: $description"
+        echo "File: $file ($option)"
+        echo "────────────────────────────────────────────────────────"
+
+        expected=$(./rodeo-vm "$file" 2>&1)
+        actual=$(./rodeo-vm $option "$file" 2>&1)
+
+        if [ "$actual" = "$expected" ]; then
+            echo "✓ Test passed successfully!"
+            ((passed++))
+        else
+            echo "✗ Test failed!"
+            diff <(echo "$expected") <(echo "$actual") | head -5
+            ((failed++))
+        fi
+
+        echo ""
+    done
+done
+
+# Lockstep runs every instance of a program on SIMD lanes; the CSV it prints
+# must be the one --batch produces running them one by one
+((total++))
+echo "────────────────────────────────────────────────────────"
+echo "Test: Lockstep matches batch"
+echo "File: test.rodeo examples/ (--batch --lockstep)"
+echo "────────────────────────────────────────────────────────"
+
+expected=$(./rodeo-vm --batch --instances=8 test.rodeo examples/ 2>/dev/null)
+actual=$(./rodeo-vm --batch --lockstep --instances=8 test.rodeo examples/ 2>/dev/null)
+
+if [ -n "$expected" ] && [ "$actual" = "$expected" ]; then
+    echo "✓ Test passed successfully!"
+    ((passed++))
+else
+    echo "✗ Test failed!"
+    diff <(echo "$expected") <(echo "$actual") | head -5
+    ((failed++))
+fi
+
+echo ""
+
+# Programs whose driver-side state is checked through --channel: each names
+# the session line rodeo-driver must print in a "// driver:" comment
+channel_tests=(
+    "examples/channel_brake.rodeo:Brake reaches the driver"
+    "examples/channel_coalesce.rodeo:Actuator writes are coalesced"
+    "examples/channel_wait_zero.rodeo:Zero and negative waits end a frame"
+)
+total=$((total + ${#channel_tests[@]}))
+
+for test_info in "${channel_tests[@]}"; do
+    IFS=':' read -r file description <<< "$test_info"
+
+    echo "────────────────────────────────────────────────────────"
+    echo "Test: $description"
+    echo "File: $file (--channel)"
+    echo "────────────────────────────────────────────────────────"
+
+    channel="rodeo-test-$$"
+    driver_log=$(mktemp)
+    ./rodeo-driver --once "$channel" > "$driver_log" 2>&1 &
+    driver=$!
+    for _ in $(seq 50); do
+        grep -q "^Listening" "$driver_log" && break
+        sleep 0.1
+    done
+
+    ./rodeo-vm --trace=off --channel="$channel" "$file" > /dev/null 2>&1
+    status=$?
+    wait $driver
+
+    expected=$(sed -n 's|^// driver: ||p' "$file")
+    actual=$(grep "^Session:" "$driver_log")
+    rm -f "$driver_log"
+
+    if [ $status -eq 0 ] && [ "$actual" = "$expected" ]; then
+        echo "✓ Test passed successfully!"
+        ((passed++))
+    else
+        echo "✗ Test failed!"
+        echo "  expected: $expected"
+        echo "  got:      $actual"
+        ((failed++))
+    fi
+
+    echo ""
+done
+
+# Sensors replayed from a recorded ride: the program's final variables must be
+# the ones its "// replay:" comment lists, and converting the ride's CSV again
+# must give the checked-in .rtl byte for byte
+((total++))
+file="examples/telemetry/replay.rodeo"
+echo "────────────────────────────────────────────────────────"
+echo "Test: Telemetry replay"
+echo "File: $file (--telemetry)"
+echo "────────────────────────────────────────────────────────"
+
+expected=$(sed -n 's|^// replay: ||p' "$file")
+actual=$(./rodeo-vm --trace=off --telemetry=examples/telemetry/ride.rtl "$file" 2>&1 |
+         sed -n 's/^│ \([a-z0-9_]*\) *= \([-0-9]*\).*/\1=\2/p' | tr '\n' ' ' | sed 's/ $//')
+
+if [ "$actual" = "$expected" ]; then
+    echo "✓ Test passed successfully!"
+    ((passed++))
+else
+    echo "✗ Test failed!"
+    echo "  expected: $expected"
+    echo "  got:      $actual"
+    ((failed++))
+fi
+
+echo ""
+
+((total++))
+echo "────────────────────────────────────────────────────────"
+echo "Test: Telemetry conversion"
+echo "File: examples/telemetry/ride.csv (--convert-telemetry)"
+echo "────────────────────────────────────────────────────────"
+
+converted=$(mktemp)
+if ./rodeo-vm --convert-telemetry="$converted" examples/telemetry/ride.csv > /dev/null 2>&1 &&
+   cmp -s "$converted" examples/telemetry/ride.rtl; then
+    echo "✓ Test passed successfully!"
+    ((passed++))
+else
+    echo "✗ Test failed!"
+    ((failed++))
+fi
+rm -f "$converted"
+
+echo ""
+
+# Malformed program images the loader must reject instead of running
+for file in examples/corrupt/*.rbc; do
+    ((total++))
+    echo "────────────────────────────────────────────────────────"
+    echo "Test: Corrupt image is rejected"
+    echo "File: $file"
+    echo "────────────────────────────────────────────────────────"
+
+    if ./rodeo-vm --trace=off "$file" 2>&1 | grep -q "corrupt program image"; then
+        echo "✓ Test passed successfully!"
+        ((passed++))
+    else
+        echo "✗ Test failed!"
+        ((failed++))
+    fi
+
+    echo ""
+done
+
+# Input that ends in the middle of a keyword prefix: each scanner must report
+# a syntax error instead of waiting for more input
+for file in examples/eof/*.rodeo; do
+    for scanner in flex fast; do
+        ((total++))
+        echo "────────────────────────────────────────────────────────"
+        echo "Test: Input ending inside a keyword is rejected"
+        echo "File: $file (--scanner=$scanner)"
+        echo "────────────────────────────────────────────────────────"
+
+        if timeout 5 ./rodeo-vm --trace=off --scanner=$scanner "$file" 2>&1 | grep -q "Syntax error"; then
+            echo "✓ Test passed successfully!"
+            ((passed++))
+        else
+            echo "✗ Test failed!"
+            ((failed++))
+        fi
+
+        echo ""
+    done
+done
+
 # Summary
 echo "════════════════════════════════════════════════════════"
 echo "  Test Summary"
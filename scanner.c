@@ -0,0 +1,186 @@
+#include "scanner.h"
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+
+enum {
+    CLASS_OTHER,
+    CLASS_SPACE,
+    CLASS_NEWLINE,
+    CLASS_LETTER,
+    CLASS_DIGIT,
+    CLASS_UNDERSCORE
+};
+
+static unsigned char char_class[256];
+static pthread_once_t char_class_once = PTHREAD_ONCE_INIT;
+
+// Keywords are placed by a hash of their length and first and last two
+// characters, which has no collisions over this set, so a lookup is one probe
+// and a memcmp. Every keyword has at least two characters.
+#define KEYWORD_SLOTS 64
+#define KEYWORD_HASH(length, first, penultimate, last) \
+    (((length) + (first) + ((penultimate) << 1) + ((last) << 1)) & (KEYWORD_SLOTS - 1))
+#define KEYWORD(text, first, penultimate, last, token) \
+    [KEYWORD_HASH(sizeof(text) - 1, first, penultimate, last)] = {text, sizeof(text) - 1, token}
+
+typedef struct {
+    const char *text;
+    int length;
+    int token;
+} Keyword;
+
+static const Keyword keywords[KEYWORD_SLOTS] = {
+    KEYWORD("if", 'i', 'i', 'f', IF),
+    KEYWORD("else", 'e', 's', 'e', ELSE),
+    KEYWORD("while", 'w', 'l', 'e', WHILE),
+    KEYWORD("speed", 's', 'e', 'd', SPEED),
+    KEYWORD("torque", 't', 'u', 'e', TORQUE),
+    KEYWORD("yaw", 'y', 'a', 'w', YAW),
+    KEYWORD("brake", 'b', 'k', 'e', BRAKE),
+    KEYWORD("wait", 'w', 'i', 't', WAIT),
+    KEYWORD("pattern", 'p', 'r', 'n', PATTERN),
+    KEYWORD("read", 'r', 'a', 'd', READ),
+    KEYWORD("CALM", 'C', 'L', 'M', CALM),
+    KEYWORD("SWIRL", 'S', 'R', 'L', SWIRL),
+    KEYWORD("AGGRESSIVE", 'A', 'V', 'E', AGGRESSIVE),
+    KEYWORD("rider", 'r', 'e', 'r', RIDER),
+    KEYWORD("tilt", 't', 'l', 't', TILT),
+    KEYWORD("rpm", 'r', 'p', 'm', RPM),
+    KEYWORD("emergency", 'e', 'c', 'y', EMERGENCY),
+    KEYWORD("time_ms", 't', 'm', 's', TIME_MS),
+    KEYWORD("time_us", 't', 'u', 's', TIME_US),
+};
+
+static void init_classes(void) {
+    for (int c = 'a'; c <= 'z'; c++) char_class[c] = CLASS_LETTER;
+    for (int c = 'A'; c <= 'Z'; c++) char_class[c] = CLASS_LETTER;
+    for (int c = '0'; c <= '9'; c++) char_class[c] = CLASS_DIGIT;
+    char_class['_'] = CLASS_UNDERSCORE;
+    char_class[' '] = CLASS_SPACE;
+    char_class['\t'] = CLASS_SPACE;
+    char_class['\n'] = CLASS_NEWLINE;
+}
+
+static int classify_word(const char *text, int length) {
+    if (length < 2) return IDENTIFIER;
+
+    const Keyword *keyword = &keywords[KEYWORD_HASH(length, (unsigned char)text[0],
+                                                    (unsigned char)text[length - 2],
+                                                    (unsigned char)text[length - 1])];
+    if (keyword->length == length && memcmp(keyword->text, text, length) == 0) {
+        return keyword->token;
+    }
+    return IDENTIFIER;
+}
+
+void scanner_init(Scanner *scanner, RodeoProgram *program, const char *source, size_t length) {
+    pthread_once(&char_class_once, init_classes);
+    scanner->cursor = source;
+    scanner->end = source + length;
+    scanner->program = program;
+}
+
+int scanner_next(Scanner *scanner, Token *token) {
+    const char *p = scanner->cursor;
+    const char *end = scanner->end;
+
+    for (;;) {
+        while (p < end && char_class[(unsigned char)*p] == CLASS_SPACE) p++;
+        if (p == end) {
+            scanner->cursor = p;
+            token->type = 0;
+            token->span.start = p;
+            token->span.length = 0;
+            token->span.line = scanner->program->line_num;
+            return 0;
+        }
+
+        const char *start = p;
+        unsigned char c = (unsigned char)*p++;
+        int type;
+
+        switch (char_class[c]) {
+            case CLASS_NEWLINE:
+                scanner->program->line_num++;
+                continue;
+
+            case CLASS_LETTER:
+                while (p < end && char_class[(unsigned char)*p] >= CLASS_LETTER) p++;
+                type = classify_word(start, (int)(p - start));
+                break;
+
+            case CLASS_DIGIT:
+                while (p < end && char_class[(unsigned char)*p] == CLASS_DIGIT) p++;
+                type = NUMBER;
+                break;
+
+            default:
+                type = 0;
+                switch (c) {
+                    case '/':
+                        if (p < end && *p == '/') {
+                            const char *newline = memchr(p, '\n', end - p);
+                            p = newline ? newline : end;
+                            continue;
+                        }
+                        type = DIV;
+                        break;
+                    case '=':
+                        if (p < end && *p == '=') { p++; type = EQ; } else type = ASSIGN;
+                        break;
+                    case '!':
+                        if (p < end && *p == '=') { p++; type = NE; }
+                        break;
+                    case '>':
+                        if (p < end && *p == '=') { p++; type = GE; } else type = GT;
+                        break;
+                    case '<':
+                        if (p < end && *p == '=') { p++; type = LE; } else type = LT;
+                        break;
+                    case '-':
+                        if (p < end && *p == '>') { p++; type = ARROW; } else type = MINUS;
+                        break;
+                    case '+': type = PLUS; break;
+                    case '*': type = MULT; break;
+                    case '(': type = LPAREN; break;
+                    case ')': type = RPAREN; break;
+                    case '{': type = LBRACE; break;
+                    case '}': type = RBRACE; break;
+                    case ';': type = SEMICOLON; break;
+                }
+                if (!type) {
+                    rodeo_add_diagnostic(scanner->program, DIAG_LEXICAL,
+                                         "unexpected character '%c'", c);
+                    continue;
+                }
+                break;
+        }
+
+        scanner->cursor = p;
+        token->type = type;
+        token->span.start = start;
+        token->span.length = (int)(p - start);
+        token->span.line = scanner->program->line_num;
+        return type;
+    }
+}
+
+int scanner_lex(Scanner *scanner, YYSTYPE *lval) {
+    Token token;
+    int type = scanner_next(scanner, &token);
+
+    if (type == IDENTIFIER) {
+        lval->symbol = interner_intern(&scanner->program->identifiers,
+                                       token.span.start, token.span.length);
+    } else if (type == NUMBER) {
+        // Saturates like atoi() on the Flex path
+        long value = 0;
+        for (int i = 0; i < token.span.length; i++) {
+            int digit = token.span.start[i] - '0';
+            value = value <= (LONG_MAX - digit) / 10 ? value * 10 + digit : LONG_MAX;
+        }
+        lval->number = (int)value;
+    }
+    return type;
+}
@@ -0,0 +1,35 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <stddef.h>
+#include "frontend.h"
+#include "parser.tab.h"
+
+// A token's text as a slice of the source; nothing is copied.
+typedef struct {
+    const char *start;
+    int length;
+    int line;
+} Span;
+
+typedef struct {
+    int type;           // parser token, 0 at the end of input
+    Span span;
+} Token;
+
+// Hand-written replacement for the Flex scanner. Accepts the same language and
+// reports the same lexical diagnostics, but reads straight from a buffer (an
+// mmap'd file or a string) that must outlive the scan.
+typedef struct {
+    const char *cursor;
+    const char *end;
+    RodeoProgram *program;  // line number, interned identifiers, diagnostics
+} Scanner;
+
+void scanner_init(Scanner *scanner, RodeoProgram *program, const char *source, size_t length);
+int scanner_next(Scanner *scanner, Token *token);
+
+// scanner_next plus the semantic value the parser expects for the token
+int scanner_lex(Scanner *scanner, YYSTYPE *lval);
+
+#endif
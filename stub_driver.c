@@ -0,0 +1,189 @@
+// Stand-in for the motor driver process. Creates a shared-memory channel,
+// applies the commands a VM sends over it to the same model as the built-in
+// simulator and publishes the resulting sensor readings after every batch.
+//
+//   rodeo-driver [--once] NAME
+//
+// Serves VMs one after another until interrupted; with --once it exits when
+// the first VM detaches. A VM that exits without detaching ends its session
+// the same way once the driver notices.
+
+#include "channel.h"
+#include <signal.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    int speed;
+    int torque;
+    int yaw;
+    int brake;
+    int pattern;
+    long waited_ms;
+    long commands;
+} DriverState;
+
+static volatile sig_atomic_t stopping = 0;
+
+// Power-on state, the same as the VM's: stopped with the brake engaged
+static void reset(DriverState *state) {
+    memset(state, 0, sizeof(*state));
+    state->brake = 1;
+}
+
+static void handle_stop(int signal_number) {
+    (void)signal_number;
+    stopping = 1;
+}
+
+static int clamp_percent(int value) {
+    if (value < 0) return 0;
+    if (value > 100) return 100;
+    return value;
+}
+
+static void apply(DriverState *state, const ChannelCommand *command) {
+    switch (command->kind) {
+        case CHANNEL_SPEED: state->speed = clamp_percent(command->value); break;
+        case CHANNEL_TORQUE: state->torque = clamp_percent(command->value); break;
+        case CHANNEL_YAW: state->yaw = command->value; break;
+        case CHANNEL_BRAKE: state->brake = command->value ? 1 : 0; break;
+        case CHANNEL_PATTERN: state->pattern = command->value; break;
+        case CHANNEL_WAIT: state->waited_ms += command->value; break;
+        default: break;
+    }
+    state->commands++;
+}
+
+static void sample(const DriverState *state, unsigned long applied, ChannelSensors *sensors) {
+    sensors->rider_present = 1;
+    sensors->tilt_angle = state->speed * state->yaw / 10;
+    if (sensors->tilt_angle > 45) sensors->tilt_angle = 45;
+    sensors->rpm = state->speed * 10;
+    sensors->emergency = 0;
+    sensors->applied = applied;
+}
+
+static void print_session(const DriverState *state) {
+    printf("Session: %ld commands, %ld ms waited, speed=%d torque=%d yaw=%d brake=%d pattern=%d\n",
+           state->commands, state->waited_ms, state->speed, state->torque, state->yaw,
+           state->brake, state->pattern);
+    fflush(stdout);
+}
+
+static void end_session(DriverState *state) {
+    print_session(state);
+    reset(state);
+}
+
+int main(int argc, char **argv) {
+    int once = 0;
+    const char *name = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--once") == 0) {
+            once = 1;
+        } else if (argv[i][0] != '-' && !name) {
+            name = argv[i];
+        } else {
+            name = NULL;
+            break;
+        }
+    }
+    if (!name) {
+        fprintf(stderr, "Usage: %s [--once] NAME\n", argv[0]);
+        return 1;
+    }
+
+    // Without SA_RESTART the idle sleep returns early and the loop sees the flag
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    Channel *channel = channel_create(name);
+    if (!channel) return 1;
+    ChannelShared *shared = channel->shared;
+
+    DriverState state;
+    reset(&state);
+    ChannelSensors sensors;
+    sample(&state, 0, &sensors);
+    channel_publish(shared, &sensors);
+
+    printf("Listening on %s\n", channel->name);
+    fflush(stdout);
+
+    // Busy-polls so a command is picked up within a cache miss or two; backs off
+    // to yielding and then to short sleeps once nobody has sent anything for a while
+    long spin_limit = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? 1000 : 0;
+    long idle = 0;
+    int done = 0;
+    int session = 0;    // pid of the VM whose commands are being applied
+    while (!stopping && !done) {
+        unsigned long from;
+        unsigned long to = channel_available(shared, &from);
+        if (from == to) {
+            idle++;
+            int dead = idle % 1000 == 0 ? channel_reap(shared) : 0;
+            if (dead) {
+                fprintf(stderr, "VM %d exited without detaching\n", dead);
+                if (session) end_session(&state);
+                session = 0;
+                if (once) done = 1;
+                continue;
+            }
+            if (idle < spin_limit) {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            } else if (idle < 1000000) {
+                sched_yield();
+            } else {
+                struct timespec pause = {0, 100000L};
+                nanosleep(&pause, NULL);
+            }
+            continue;
+        }
+        idle = 0;
+
+        unsigned long position;
+        for (position = from; position != to; position++) {
+            const ChannelCommand *command = channel_command(shared, position);
+            if (command->kind == CHANNEL_ATTACH) {
+                // The previous VM died and this one took its place first
+                if (session) {
+                    fprintf(stderr, "VM %d exited without detaching\n", session);
+                    end_session(&state);
+                    if (once) {
+                        done = 1;
+                        break;
+                    }
+                }
+                session = command->value;
+                continue;
+            }
+            if (command->kind == CHANNEL_DETACH) {
+                end_session(&state);
+                session = 0;
+                if (once) {
+                    done = 1;
+                    position++;
+                    break;
+                }
+                continue;
+            }
+            apply(&state, command);
+        }
+        channel_consume(shared, position);
+
+        sample(&state, position, &sensors);
+        channel_publish(shared, &sensors);
+    }
+
+    channel_close(channel);
+    return 0;
+}
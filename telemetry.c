@@ -0,0 +1,212 @@
+#include "telemetry.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Telemetry *telemetry_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TelemetryHeader)) {
+        fprintf(stderr, "Error: %s is not a telemetry recording\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    char *base = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+
+    // Sample and index sizes are checked against the file size with divisions,
+    // so a corrupt count cannot overflow the arithmetic
+    TelemetryHeader *header = (TelemetryHeader *)base;
+    size_t body = size - sizeof(TelemetryHeader);
+    long long count = header->sample_count;
+    long long index_count = 0;
+    int valid = memcmp(header->magic, TELEMETRY_MAGIC, 4) == 0 &&
+                header->version == TELEMETRY_VERSION &&
+                header->sample_size == (int)sizeof(TelemetrySample) &&
+                header->index_stride > 0 &&
+                count > 0 && (unsigned long long)count <= body / sizeof(TelemetrySample);
+    if (valid) {
+        index_count = (count + header->index_stride - 1) / header->index_stride;
+        valid = count * sizeof(TelemetrySample) + index_count * sizeof(long long) == body;
+    }
+    if (!valid) {
+        fprintf(stderr, "Error: %s: unsupported or corrupt telemetry recording\n", path);
+        munmap(base, size);
+        return NULL;
+    }
+
+    // Replays mostly move forward through the samples
+    madvise(base, size, MADV_SEQUENTIAL);
+
+    Telemetry *telemetry = (Telemetry *)calloc(1, sizeof(Telemetry));
+    telemetry->samples = (const TelemetrySample *)(base + sizeof(TelemetryHeader));
+    telemetry->count = count;
+    telemetry->index = (const long long *)(telemetry->samples + count);
+    telemetry->index_count = index_count;
+    telemetry->stride = header->index_stride;
+    telemetry->mapping = base;
+    telemetry->mapping_size = size;
+    return telemetry;
+}
+
+void telemetry_close(Telemetry *telemetry) {
+    if (!telemetry) return;
+    munmap(telemetry->mapping, telemetry->mapping_size);
+    free(telemetry);
+}
+
+// Last position in [low, high) whose time is <= time, or low - 1 if none
+static long long last_at_or_before(const long long *times, size_t step, long long low,
+                                   long long high, long long time) {
+    while (low < high) {
+        long long mid = low + (high - low) / 2;
+        if (*(const long long *)((const char *)times + mid * step) <= time) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low - 1;
+}
+
+const TelemetrySample *telemetry_lookup(const Telemetry *telemetry, long elapsed_ms,
+                                        long long *cursor) {
+    const TelemetrySample *samples = telemetry->samples;
+    long long count = telemetry->count;
+    long long time = samples[0].time_ms + elapsed_ms;
+    long long i = *cursor;
+
+    if (i < 0 || i >= count) i = 0;
+
+    // Simulated time only moves forward between waits, usually by less than
+    // the spacing of the samples
+    if (samples[i].time_ms <= time) {
+        for (int step = 0; step < 8; step++) {
+            if (i + 1 == count || samples[i + 1].time_ms > time) {
+                *cursor = i;
+                return &samples[i];
+            }
+            i++;
+        }
+    }
+
+    long long block = last_at_or_before(telemetry->index, sizeof(long long), 0,
+                                        telemetry->index_count, time);
+    if (block < 0) {
+        *cursor = 0;
+        return &samples[0];
+    }
+
+    long long low = block * telemetry->stride;
+    long long high = low + telemetry->stride < count ? low + telemetry->stride : count;
+    i = last_at_or_before(&samples[0].time_ms, sizeof(TelemetrySample), low, high, time);
+    *cursor = i;
+    return &samples[i];
+}
+
+static void write_header(FILE *out, long long count) {
+    TelemetryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEMETRY_MAGIC, 4);
+    header.version = TELEMETRY_VERSION;
+    header.sample_size = sizeof(TelemetrySample);
+    header.index_stride = TELEMETRY_INDEX_STRIDE;
+    header.sample_count = count;
+    fwrite(&header, sizeof(header), 1, out);
+}
+
+int telemetry_convert_csv(const char *csv_path, const char *out_path) {
+    FILE *in = fopen(csv_path, "r");
+    if (!in) {
+        perror(csv_path);
+        return -1;
+    }
+    FILE *out = fopen(out_path, "wb");
+    if (!out) {
+        perror(out_path);
+        fclose(in);
+        return -1;
+    }
+
+    // The count is patched in once the samples are written
+    write_header(out, 0);
+
+    long long *index = NULL;
+    long long index_count = 0;
+    long long index_capacity = 0;
+    long long count = 0;
+    long long last_time = 0;
+    long line_num = 0;
+    int status = 0;
+
+    char *line = NULL;
+    size_t line_capacity = 0;
+    while (getline(&line, &line_capacity, in) != -1) {
+        line_num++;
+        char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        // Blank lines, comments and a header row
+        if (*p == '\0' || *p == '#' || (line_num == 1 && !isdigit((unsigned char)*p))) continue;
+
+        TelemetrySample sample;
+        if (sscanf(p, "%lld , %d , %d , %d , %d", &sample.time_ms, &sample.rider_present,
+                   &sample.tilt_angle, &sample.rpm, &sample.emergency) != 5) {
+            fprintf(stderr, "Error: %s:%ld: expected time_ms,rider,tilt,rpm,emergency\n",
+                    csv_path, line_num);
+            status = -1;
+            break;
+        }
+        if (count > 0 && sample.time_ms < last_time) {
+            fprintf(stderr, "Error: %s:%ld: time goes backwards\n", csv_path, line_num);
+            status = -1;
+            break;
+        }
+
+        if (count % TELEMETRY_INDEX_STRIDE == 0) {
+            if (index_count == index_capacity) {
+                index_capacity = index_capacity ? index_capacity * 2 : 64;
+                index = (long long *)realloc(index, sizeof(long long) * index_capacity);
+            }
+            index[index_count++] = sample.time_ms;
+        }
+        fwrite(&sample, sizeof(sample), 1, out);
+        last_time = sample.time_ms;
+        count++;
+    }
+    free(line);
+    fclose(in);
+
+    if (status == 0 && count == 0) {
+        fprintf(stderr, "Error: %s: no samples\n", csv_path);
+        status = -1;
+    }
+    if (status == 0) {
+        fwrite(index, sizeof(long long), index_count, out);
+        rewind(out);
+        write_header(out, count);
+    }
+    free(index);
+
+    if ((ferror(out) | fclose(out)) && status == 0) {
+        fprintf(stderr, "Error: failed to write %s\n", out_path);
+        status = -1;
+    }
+    if (status != 0) remove(out_path);
+    return status;
+}
@@ -0,0 +1,57 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+
+#define TELEMETRY_MAGIC "RTLM"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_INDEX_STRIDE 4096
+
+// Layout, in native byte order: this header, `sample_count` samples sorted by
+// time, then the time of every `index_stride`-th sample as a long long. The
+// index is small enough to stay cached, so a lookup touches one or two pages
+// of samples however large the recording is.
+typedef struct {
+    char magic[4];
+    int version;
+    int sample_size;
+    int index_stride;
+    long long sample_count;
+} TelemetryHeader;
+
+typedef struct {
+    long long time_ms;
+    int rider_present;
+    int tilt_angle;
+    int rpm;
+    int emergency;
+} TelemetrySample;
+
+// A recording mapped read-only. It is never written, so any number of VMs can
+// replay it at once, each with its own cursor.
+typedef struct {
+    const TelemetrySample *samples;
+    long long count;
+    const long long *index;
+    long long index_count;
+    int stride;
+
+    void *mapping;
+    size_t mapping_size;
+} Telemetry;
+
+Telemetry *telemetry_open(const char *path);
+void telemetry_close(Telemetry *telemetry);
+
+// The sample in effect `elapsed_ms` after the first one: the last sample at or
+// before that time. `cursor` remembers the previous position, so a replay that
+// moves forward costs a comparison or two instead of a search.
+const TelemetrySample *telemetry_lookup(const Telemetry *telemetry, long elapsed_ms,
+                                        long long *cursor);
+
+// Converts a CSV log with rows `time_ms,rider,tilt,rpm,emergency`, in
+// non-decreasing time order, into the binary format. Streams the input, so
+// the log does not have to fit in memory.
+int telemetry_convert_csv(const char *csv_path, const char *out_path);
+
+#endif
@@ -0,0 +1,174 @@
+#include "trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *pattern_name[] = {"CALM", "SWIRL", "AGGRESSIVE"};
+static const char *sensor_name[] = {"rider", "tilt", "rpm", "emergency", "time_ms", "time_us"};
+static const char *event_name[] = {
+    "var", "if", "while", "while_exit", "speed", "torque",
+    "yaw", "brake", "wait", "pattern", "sensor"
+};
+
+void trace_init(TraceLog *log, TraceLevel level) {
+    memset(log, 0, sizeof(TraceLog));
+    log->level = level;
+    if (level == TRACE_FULL) {
+        log->events = (TraceEvent *)malloc(sizeof(TraceEvent) * TRACE_BUFFER_EVENTS);
+    }
+}
+
+int trace_open_file(TraceLog *log, const char *path) {
+    log->file = fopen(path, "wb");
+    if (!log->file) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+int trace_parse_level(const char *name, TraceLevel *level) {
+    if (strcmp(name, "off") == 0) {
+        *level = TRACE_OFF;
+    } else if (strcmp(name, "summary") == 0) {
+        *level = TRACE_SUMMARY;
+    } else if (strcmp(name, "full") == 0) {
+        *level = TRACE_FULL;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// Binary layout: magic, version, name count, NUL-terminated slot names,
+// then raw TraceEvent records until end of file.
+static void write_header(TraceLog *log) {
+    int version = TRACE_VERSION;
+
+    fwrite(TRACE_MAGIC, 1, 4, log->file);
+    fwrite(&version, sizeof(int), 1, log->file);
+    fwrite(&log->name_count, sizeof(int), 1, log->file);
+    for (int i = 0; i < log->name_count; i++) {
+        fwrite(log->names[i], 1, strlen(log->names[i]) + 1, log->file);
+    }
+    log->header_written = 1;
+}
+
+static void decode_event(TraceLog *log, TraceEvent *e) {
+    switch (e->type) {
+        case EVENT_VAR:
+            printf("  [VAR] %s = %d\n", log->names[e->slot], e->value);
+            break;
+        case EVENT_IF:
+            printf("  [IF] condition = %s\n", e->value ? "TRUE" : "FALSE");
+            break;
+        case EVENT_LOOP_ENTER:
+            printf("  [WHILE] entering loop\n");
+            break;
+        case EVENT_LOOP_EXIT:
+            printf("  [WHILE] exited after %d iterations\n", e->value);
+            break;
+        case EVENT_SPEED:
+            printf("  [SPEED] set to %d%%\n", e->value);
+            break;
+        case EVENT_TORQUE:
+            printf("  [TORQUE] set to %d%%\n", e->value);
+            break;
+        case EVENT_YAW:
+            printf("  [YAW] set to %d degrees/step\n", e->value);
+            break;
+        case EVENT_BRAKE:
+            printf("  [BRAKE] %s\n", e->value ? "ON" : "OFF");
+            break;
+        case EVENT_WAIT:
+            printf("  [WAIT] %d ms\n", e->value);
+            break;
+        case EVENT_PATTERN:
+            printf("  [PATTERN] set to %s\n", pattern_name[e->aux]);
+            break;
+        case EVENT_SENSOR:
+            printf("  [SENSOR] %s -> %s = %d\n",
+                   sensor_name[e->aux], log->names[e->slot], e->value);
+            break;
+    }
+}
+
+void trace_flush(TraceLog *log) {
+    if (log->count == 0) return;
+
+    if (log->file) {
+        if (!log->header_written) write_header(log);
+        fwrite(log->events, sizeof(TraceEvent), log->count, log->file);
+    } else {
+        for (int i = 0; i < log->count; i++) {
+            decode_event(log, &log->events[i]);
+        }
+    }
+    log->count = 0;
+}
+
+void trace_print_summary(TraceLog *log) {
+    long total = 0;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        total += log->counts[i];
+    }
+
+    printf("  [TRACE] %ld events\n", total);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        if (log->counts[i] > 0) {
+            printf("  [TRACE] %-10s %ld\n", event_name[i], log->counts[i]);
+        }
+    }
+}
+
+const char *trace_event_name(TraceEventType type) {
+    return event_name[type];
+}
+
+static int skip_names(FILE *file, int count) {
+    int c;
+    while (count > 0 && (c = fgetc(file)) != EOF) {
+        if (c == '\0') count--;
+    }
+    return count == 0 ? 0 : -1;
+}
+
+int trace_read_file(const char *path, TraceVisitor visit, void *data) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+
+    char magic[4];
+    int version, name_count;
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, TRACE_MAGIC, 4) != 0 ||
+        fread(&version, sizeof(int), 1, file) != 1 || version != TRACE_VERSION ||
+        fread(&name_count, sizeof(int), 1, file) != 1 || name_count < 0 ||
+        skip_names(file, name_count) != 0) {
+        fprintf(stderr, "Error: %s is not a trace file\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    TraceEvent *events = (TraceEvent *)malloc(sizeof(TraceEvent) * TRACE_BUFFER_EVENTS);
+    size_t count;
+    while ((count = fread(events, sizeof(TraceEvent), TRACE_BUFFER_EVENTS, file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            if (events[i].type < EVENT_COUNT) visit(data, &events[i]);
+        }
+    }
+    free(events);
+    fclose(file);
+    return 0;
+}
+
+void trace_close(TraceLog *log) {
+    trace_flush(log);
+    if (log->file) {
+        if (!log->header_written) write_header(log);
+        fclose(log->file);
+        log->file = NULL;
+    }
+    free(log->events);
+    log->events = NULL;
+}
@@ -0,0 +1,79 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+#define TRACE_BUFFER_EVENTS 4096
+#define TRACE_MAGIC "RTRC"
+#define TRACE_VERSION 1
+
+typedef enum {
+    TRACE_OFF,          // final state only
+    TRACE_SUMMARY,      // event counts at the end of the run
+    TRACE_FULL          // every event, decoded or written as binary records
+} TraceLevel;
+
+typedef enum {
+    EVENT_VAR,
+    EVENT_IF,
+    EVENT_LOOP_ENTER,
+    EVENT_LOOP_EXIT,
+    EVENT_SPEED,
+    EVENT_TORQUE,
+    EVENT_YAW,
+    EVENT_BRAKE,
+    EVENT_WAIT,
+    EVENT_PATTERN,
+    EVENT_SENSOR,
+    EVENT_COUNT
+} TraceEventType;
+
+typedef struct {
+    unsigned char type;
+    unsigned char aux;      // Pattern or SensorType
+    unsigned short slot;    // register slot for VAR/SENSOR
+    int value;
+} TraceEvent;
+
+typedef struct {
+    TraceLevel level;
+    TraceEvent *events;
+    int count;
+    long counts[EVENT_COUNT];
+
+    char **names;           // slot names used when decoding
+    int name_count;
+
+    FILE *file;             // binary sink; events are decoded to stdout when NULL
+    int header_written;
+} TraceLog;
+
+void trace_init(TraceLog *log, TraceLevel level);
+int trace_open_file(TraceLog *log, const char *path);
+void trace_flush(TraceLog *log);
+void trace_print_summary(TraceLog *log);
+void trace_close(TraceLog *log);
+
+int trace_parse_level(const char *name, TraceLevel *level);
+const char *trace_event_name(TraceEventType type);
+
+// Calls `visit` for every event of a binary trace file, in order.
+typedef void (*TraceVisitor)(void *data, const TraceEvent *event);
+int trace_read_file(const char *path, TraceVisitor visit, void *data);
+
+static inline void trace_event(TraceLog *log, TraceEventType type, int aux, int slot, int value) {
+    if (log->level == TRACE_OFF) return;
+    log->counts[type]++;
+    if (log->level != TRACE_FULL) return;
+
+    if (log->count == TRACE_BUFFER_EVENTS) {
+        trace_flush(log);
+    }
+    TraceEvent *e = &log->events[log->count++];
+    e->type = type;
+    e->aux = aux;
+    e->slot = slot;
+    e->value = value;
+}
+
+#endif
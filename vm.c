@@ -1,14 +1,11 @@
 #include "vm.h"
+#include "jit.h"
 #include <unistd.h>
-#include <sys/time.h>
 
-long get_time_ms() {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-}
-
-void vm_init(VMContext *ctx) {
+void vm_init(VMContext *ctx, TraceLevel trace_level) {
+    ctx->registers = NULL;
+    ctx->register_capacity = 0;
+    ctx->names = NULL;
     ctx->var_count = 0;
     
     ctx->rodeo.speed = 0;
@@ -21,100 +18,124 @@ void vm_init(VMContext *ctx) {
     ctx->rodeo.tilt_angle = 0;
     ctx->rodeo.rpm = 0;
     ctx->rodeo.emergency = 0;
-    ctx->rodeo.start_time_ms = get_time_ms();
+    ctx->rodeo.start_time_us = 0;
+    ctx->rodeo.sim_time_ms = 0;
+    ctx->time_mode = TIME_VIRTUAL;
+    rodeo_clock_init(&ctx->clock, RODEO_CLOCK_COARSE, 0);
+    ctx->seed = 0;
+    ctx->engine = ENGINE_INTERPRETER;
+    ctx->backend = NULL;
+    ctx->backend_data = NULL;
+    ctx->pending = 0;
+    ctx->unsynced = 0;
+    memset(&ctx->frame, 0, sizeof(ctx->frame));
+    
+    trace_init(&ctx->trace, trace_level);
+    if (trace_level == TRACE_OFF) return;
     
     printf("\n╔════════════════════════════════════════════╗\n");
     printf("║    RODEO VM - Mechanical Bull Simulator   ║\n");
     printf("╚════════════════════════════════════════════╝\n\n");
 }
 
-int vm_get_variable(VMContext *ctx, const char *name) {
-    for (int i = 0; i < ctx->var_count; i++) {
-        if (strcmp(ctx->variables[i].name, name) == 0) {
-            return ctx->variables[i].value;
-        }
-    }
-    return 0; 
-}
+// New registers start at zero; ones the context already had keep their values.
+void vm_reserve_registers(VMContext *ctx, int count) {
+    if (count <= ctx->register_capacity) return;
 
-void vm_set_variable(VMContext *ctx, const char *name, int value) {
-    for (int i = 0; i < ctx->var_count; i++) {
-        if (strcmp(ctx->variables[i].name, name) == 0) {
-            ctx->variables[i].value = value;
-            return;
-        }
-    }
-    
-    if (ctx->var_count < MAX_VARIABLES) {
-        ctx->variables[ctx->var_count].name = strdup(name);
-        ctx->variables[ctx->var_count].value = value;
-        ctx->var_count++;
-    } else {
-        fprintf(stderr, "Error: Maximum number of variables exceeded\n");
-    }
+    ctx->registers = (int *)realloc(ctx->registers, sizeof(int) * count);
+    memset(ctx->registers + ctx->register_capacity, 0,
+           sizeof(int) * (count - ctx->register_capacity));
+    ctx->register_capacity = count;
 }
 
-int vm_eval_expression(VMContext *ctx, Expression *expr) {
-    if (!expr) return 0;
-    
-    switch (expr->type) {
-        case EXPR_NUMBER:
-            return expr->data.number;
-            
-        case EXPR_IDENTIFIER:
-            return vm_get_variable(ctx, expr->data.identifier);
-            
-        case EXPR_BINARY_OP:
-            {
-                int left = vm_eval_expression(ctx, expr->data.binary.left);
-                int right = vm_eval_expression(ctx, expr->data.binary.right);
-                
-                switch (expr->data.binary.op) {
-                    case OP_ADD: return left + right;
-                    case OP_SUB: return left - right;
-                    case OP_MUL: return left * right;
-                    case OP_DIV: 
-                        if (right == 0) {
-                            fprintf(stderr, "Error: Division by zero\n");
-                            return 0;
-                        }
-                        return left / right;
-                    default: return 0;
-                }
-            }
+int vm_set_backend(VMContext *ctx, const VMBackend *backend, void *data) {
+#ifdef VM_STATIC_BACKEND
+    if (backend) {
+        fprintf(stderr, "Error: built with BACKEND=static, cannot use the %s backend\n",
+                backend->name);
+        return -1;
     }
+#endif
+    ctx->backend = backend;
+    ctx->backend_data = data;
+
+    // Whatever the backend starts from, the first frame sends every setting
+    // (the brake in particular), even ones the program never writes
+    ctx->pending = VM_FRAME_ALL;
+    ctx->unsynced = VM_FRAME_ALL;
+    memset(&ctx->frame, 0, sizeof(ctx->frame));
     return 0;
 }
 
-int vm_eval_condition(VMContext *ctx, Condition *cond) {
-    if (!cond) return 0;
-    
-    int left = vm_eval_expression(ctx, cond->left);
-    int right = vm_eval_expression(ctx, cond->right);
-    
-    switch (cond->op) {
-        case REL_EQ: return left == right;
-        case REL_NE: return left != right;
-        case REL_GT: return left > right;
-        case REL_LT: return left < right;
-        case REL_GE: return left >= right;
-        case REL_LE: return left <= right;
-        default: return 0;
-    }
+// Sends the actuators written since the last frame, skipping any that ended up
+// back at the value the backend was last sent
+void vm_flush_actuators(VMContext *ctx) {
+    if (!VM_HAS_BACKEND(ctx) || !ctx->pending) return;
+
+    RodeoState *rodeo = &ctx->rodeo;
+    VMFrame *frame = &ctx->frame;
+    unsigned int differs = ctx->unsynced;
+    if (frame->speed != rodeo->speed) differs |= VM_FRAME_SPEED;
+    if (frame->torque != rodeo->torque) differs |= VM_FRAME_TORQUE;
+    if (frame->yaw != rodeo->yaw) differs |= VM_FRAME_YAW;
+    if (frame->brake != rodeo->brake) differs |= VM_FRAME_BRAKE;
+    if (frame->pattern != rodeo->pattern) differs |= VM_FRAME_PATTERN;
+
+    unsigned int changed = ctx->pending & differs;
+    ctx->pending = 0;
+    ctx->unsynced &= ~changed;
+    if (!changed) return;
+
+    // Settings that were not written still match the previous frame
+    frame->changed = changed;
+    frame->speed = rodeo->speed;
+    frame->torque = rodeo->torque;
+    frame->yaw = rodeo->yaw;
+    frame->brake = rodeo->brake;
+    frame->pattern = rodeo->pattern;
+    ctx->backend->commit(ctx, frame);
 }
 
+// The vectorized kernels in fleet.c implement the same model; keep them in step.
 void vm_simulate_sensors(VMContext *ctx) {
     ctx->rodeo.rider_present = (ctx->rodeo.speed > 0) ? 1 : 1; 
     
     ctx->rodeo.tilt_angle = (ctx->rodeo.speed * ctx->rodeo.yaw) / 10;
+    if (ctx->seed) {
+        // xorshift32: seeded runs get +-3 degrees of tilt noise
+        ctx->seed ^= ctx->seed << 13;
+        ctx->seed ^= ctx->seed >> 17;
+        ctx->seed ^= ctx->seed << 5;
+        ctx->rodeo.tilt_angle += (int)(ctx->seed % 7) - 3;
+    }
     if (ctx->rodeo.tilt_angle > 45) ctx->rodeo.tilt_angle = 45;
     
     ctx->rodeo.rpm = ctx->rodeo.speed * 10;
     
 }
 
+// Backend readings are mirrored into RodeoState for vm_print_state
+static int read_backend(VMContext *ctx, SensorType sensor) {
+    int value = ctx->backend->read_sensor(ctx, sensor);
+    switch (sensor) {
+        case SENSOR_RIDER: ctx->rodeo.rider_present = value; break;
+        case SENSOR_TILT: ctx->rodeo.tilt_angle = value; break;
+        case SENSOR_RPM: ctx->rodeo.rpm = value; break;
+        case SENSOR_EMERGENCY: ctx->rodeo.emergency = value; break;
+        default: break;
+    }
+    return value;
+}
+
 int vm_read_sensor(VMContext *ctx, SensorType sensor) {
-    vm_simulate_sensors(ctx);
+    if (VM_HAS_BACKEND(ctx)) {
+        if (sensor != SENSOR_TIME_MS && sensor != SENSOR_TIME_US) {
+            vm_flush_actuators(ctx);
+            return read_backend(ctx, sensor);
+        }
+    } else {
+        vm_simulate_sensors(ctx);
+    }
     
     switch (sensor) {
         case SENSOR_RIDER:
@@ -130,147 +151,286 @@ int vm_read_sensor(VMContext *ctx, SensorType sensor) {
             return ctx->rodeo.emergency;
             
         case SENSOR_TIME_MS:
-            return (int)(get_time_ms() - ctx->rodeo.start_time_ms);
+            if (ctx->time_mode == TIME_REAL) {
+                return (int)((rodeo_clock_now_us(&ctx->clock) - ctx->rodeo.start_time_us) / 1000);
+            }
+            return (int)ctx->rodeo.sim_time_ms;
+
+        case SENSOR_TIME_US:
+            // Wraps after about 35 minutes
+            if (ctx->time_mode == TIME_REAL) {
+                return (int)(rodeo_clock_now_us(&ctx->clock) - ctx->rodeo.start_time_us);
+            }
+            return (int)(ctx->rodeo.sim_time_ms * 1000);
             
         default:
             return 0;
     }
 }
 
-void vm_execute_statement(VMContext *ctx, ASTNode *stmt) {
-    if (!stmt) return;
-    
-    switch (stmt->type) {
-        case STMT_ASSIGNMENT:
-            {
-                int value = vm_eval_expression(ctx, stmt->data.assignment.expr);
-                vm_set_variable(ctx, stmt->data.assignment.var_name, value);
-                printf("  [VAR] %s = %d\n", stmt->data.assignment.var_name, value);
-            }
-            break;
-            
-        case STMT_IF:
-            {
-                int cond_result = vm_eval_condition(ctx, stmt->data.if_stmt.condition);
-                printf("  [IF] condition = %s\n", cond_result ? "TRUE" : "FALSE");
-                
-                if (cond_result) {
-                    ASTNode *current = stmt->data.if_stmt.then_block;
-                    while (current) {
-                        vm_execute_statement(ctx, current);
-                        current = current->next;
-                    }
-                } else if (stmt->data.if_stmt.else_block) {
-                    ASTNode *current = stmt->data.if_stmt.else_block;
-                    while (current) {
-                        vm_execute_statement(ctx, current);
-                        current = current->next;
-                    }
+// Advances the simulated clock. In real-time mode the VM then sleeps until the
+// wall clock catches up with it, so time spent executing between waits does
+// not accumulate as drift.
+void vm_wait(VMContext *ctx, int ms) {
+    // wait(0) still marks a frame boundary for the backend
+    if (ms < 0) ms = 0;
+    ctx->rodeo.sim_time_ms += ms;
+    if (VM_HAS_BACKEND(ctx)) {
+        vm_flush_actuators(ctx);
+        ctx->backend->wait(ctx, ms);
+    }
+
+    if (ctx->time_mode == TIME_REAL && ms > 0) {
+        rodeo_clock_invalidate(&ctx->clock);
+        long remaining = ctx->rodeo.start_time_us + ctx->rodeo.sim_time_ms * 1000 -
+                         rodeo_clock_read_source(ctx->clock.source);
+        if (remaining > 0) {
+            struct timespec ts;
+            ts.tv_sec = remaining / 1000000;
+            ts.tv_nsec = (remaining % 1000000) * 1000L;
+            while (nanosleep(&ts, &ts) != 0) {}
+        }
+    }
+}
+
+static inline int compare(int op, int left, int right) {
+    switch (op) {
+        case BC_EQ: return left == right;
+        case BC_NE: return left != right;
+        case BC_GT: return left > right;
+        case BC_LT: return left < right;
+        case BC_GE: return left >= right;
+        default:    return left <= right;
+    }
+}
+
+// With VM_THREADED_DISPATCH (see DISPATCH in the Makefile) every handler jumps
+// straight to the next one through a label table, so each opcode gets its own
+// indirect branch. Otherwise the same handlers are the cases of a switch.
+#if defined(VM_THREADED_DISPATCH) && defined(__GNUC__)
+#define VM_SWITCH(op)   goto *dispatch[op];
+#define VM_CASE(name)   op_##name
+#define VM_NEXT         do { ins = &code[pc++]; goto *dispatch[ins->op]; } while (0)
+#else
+#undef VM_THREADED_DISPATCH
+#define VM_SWITCH(op)   switch (op)
+#define VM_CASE(name)   case BC_##name
+#define VM_NEXT         break
+#endif
+
+static void interpret(VMContext *ctx, Bytecode *bc, int *stack, int *loops) {
+    TraceLog *trace = &ctx->trace;
+    int *registers = ctx->registers;
+    const Instruction *code = bc->code;
+    int pc = 0;
+    int sp = 0;
+
+    const Instruction *ins;
+#ifdef VM_THREADED_DISPATCH
+    static const void *const dispatch[] = {
+        [BC_PUSH] = &&op_PUSH, [BC_LOAD] = &&op_LOAD, [BC_STORE] = &&op_STORE,
+        [BC_ADD] = &&op_ADD, [BC_SUB] = &&op_SUB, [BC_MUL] = &&op_MUL, [BC_DIV] = &&op_DIV,
+        [BC_EQ] = &&op_EQ, [BC_NE] = &&op_NE, [BC_GT] = &&op_GT, [BC_LT] = &&op_LT,
+        [BC_GE] = &&op_GE, [BC_LE] = &&op_LE, [BC_JUMP] = &&op_JUMP,
+        [BC_JUMP_IF_FALSE] = &&op_JUMP_IF_FALSE, [BC_BRANCH] = &&op_BRANCH,
+        [BC_LOOP_ENTER] = &&op_LOOP_ENTER, [BC_LOOP_NEXT] = &&op_LOOP_NEXT,
+        [BC_LOOP_EXIT] = &&op_LOOP_EXIT, [BC_SPEED] = &&op_SPEED, [BC_TORQUE] = &&op_TORQUE,
+        [BC_YAW] = &&op_YAW, [BC_BRAKE] = &&op_BRAKE, [BC_WAIT] = &&op_WAIT,
+        [BC_PATTERN] = &&op_PATTERN, [BC_READ] = &&op_READ, [BC_HALT] = &&op_HALT,
+        [BC_READ_BRANCH] = &&op_READ_BRANCH, [BC_BRAKE_SPEED] = &&op_BRAKE_SPEED,
+        [BC_SPEED_BRAKE] = &&op_SPEED_BRAKE
+    };
+#endif
+
+    for (;;) {
+        ins = &code[pc++];
+
+        VM_SWITCH(ins->op) {
+            VM_CASE(PUSH):
+                stack[sp++] = ins->arg;
+                VM_NEXT;
+
+            VM_CASE(LOAD):
+                stack[sp++] = registers[ins->arg];
+                VM_NEXT;
+
+            VM_CASE(STORE):
+                {
+                    int value = stack[--sp];
+                    registers[ins->arg] = value;
+                    trace_event(trace, EVENT_VAR, 0, ins->arg, value);
                 }
-            }
-            break;
-            
-        case STMT_WHILE:
-            {
-                printf("  [WHILE] entering loop\n");
-                int iterations = 0;
-                while (vm_eval_condition(ctx, stmt->data.while_stmt.condition)) {
-                    ASTNode *current = stmt->data.while_stmt.body;
-                    while (current) {
-                        vm_execute_statement(ctx, current);
-                        current = current->next;
-                    }
-                    iterations++;
-                    if (iterations > 10000) {
-                        fprintf(stderr, "  [WARNING] Loop exceeded 10000 iterations, breaking\n");
-                        break;
-                    }
+                VM_NEXT;
+
+            VM_CASE(ADD): sp--; stack[sp - 1] = stack[sp - 1] + stack[sp]; VM_NEXT;
+            VM_CASE(SUB): sp--; stack[sp - 1] = stack[sp - 1] - stack[sp]; VM_NEXT;
+            VM_CASE(MUL): sp--; stack[sp - 1] = stack[sp - 1] * stack[sp]; VM_NEXT;
+            VM_CASE(DIV):
+                sp--;
+                if (stack[sp] == 0) {
+                    fprintf(stderr, "Error: Division by zero\n");
+                    stack[sp - 1] = 0;
+                } else {
+                    stack[sp - 1] = stack[sp - 1] / stack[sp];
                 }
-                printf("  [WHILE] exited after %d iterations\n", iterations);
-            }
-            break;
-            
-        case STMT_SPEED:
-            {
-                int speed = vm_eval_expression(ctx, stmt->data.speed_cmd.expr);
-                if (speed < 0) speed = 0;
-                if (speed > 100) speed = 100;
-                ctx->rodeo.speed = speed;
-                printf("  [SPEED] set to %d%%\n", speed);
-            }
-            break;
-            
-        case STMT_TORQUE:
-            {
-                int torque = vm_eval_expression(ctx, stmt->data.torque_cmd.expr);
-                if (torque < 0) torque = 0;
-                if (torque > 100) torque = 100;
-                ctx->rodeo.torque = torque;
-                printf("  [TORQUE] set to %d%%\n", torque);
-            }
-            break;
-            
-        case STMT_YAW:
-            {
-                int yaw = vm_eval_expression(ctx, stmt->data.yaw_cmd.expr);
-                ctx->rodeo.yaw = yaw;
-                printf("  [YAW] set to %d degrees/step\n", yaw);
-            }
-            break;
-            
-        case STMT_BRAKE:
-            {
-                int brake = vm_eval_expression(ctx, stmt->data.brake_cmd.expr);
-                ctx->rodeo.brake = brake ? 1 : 0;
-                printf("  [BRAKE] %s\n", ctx->rodeo.brake ? "ON" : "OFF");
-            }
-            break;
-            
-        case STMT_WAIT:
-            {
-                int wait_ms = vm_eval_expression(ctx, stmt->data.wait_cmd.expr);
-                printf("  [WAIT] %d ms\n", wait_ms);
-            }
-            break;
-            
-        case STMT_PATTERN:
-            {
-                ctx->rodeo.pattern = stmt->data.pattern_cmd.pattern;
-                const char *pattern_name[] = {"CALM", "SWIRL", "AGGRESSIVE"};
-                printf("  [PATTERN] set to %s\n", pattern_name[ctx->rodeo.pattern]);
-            }
-            break;
-            
-        case STMT_SENSOR_READ:
-            {
-                int value = vm_read_sensor(ctx, stmt->data.sensor_read.sensor);
-                vm_set_variable(ctx, stmt->data.sensor_read.var_name, value);
-                const char *sensor_name[] = {"rider", "tilt", "rpm", "emergency", "time_ms"};
-                printf("  [SENSOR] %s -> %s = %d\n", 
-                       sensor_name[stmt->data.sensor_read.sensor],
-                       stmt->data.sensor_read.var_name,
-                       value);
-            }
-            break;
-            
-        case STMT_BLOCK:
-            for (int i = 0; i < stmt->data.block.count; i++) {
-                vm_execute_statement(ctx, stmt->data.block.statements[i]);
-            }
-            break;
+                VM_NEXT;
+
+            VM_CASE(EQ): sp--; stack[sp - 1] = stack[sp - 1] == stack[sp]; VM_NEXT;
+            VM_CASE(NE): sp--; stack[sp - 1] = stack[sp - 1] != stack[sp]; VM_NEXT;
+            VM_CASE(GT): sp--; stack[sp - 1] = stack[sp - 1] > stack[sp]; VM_NEXT;
+            VM_CASE(LT): sp--; stack[sp - 1] = stack[sp - 1] < stack[sp]; VM_NEXT;
+            VM_CASE(GE): sp--; stack[sp - 1] = stack[sp - 1] >= stack[sp]; VM_NEXT;
+            VM_CASE(LE): sp--; stack[sp - 1] = stack[sp - 1] <= stack[sp]; VM_NEXT;
+
+            VM_CASE(JUMP):
+                pc = ins->arg;
+                VM_NEXT;
+
+            VM_CASE(JUMP_IF_FALSE):
+                if (!stack[--sp]) pc = ins->arg;
+                VM_NEXT;
+
+            VM_CASE(BRANCH):
+                {
+                    int cond_result = stack[--sp];
+                    trace_event(trace, EVENT_IF, 0, 0, cond_result);
+                    if (!cond_result) pc = ins->arg;
+                }
+                VM_NEXT;
+
+            VM_CASE(LOOP_ENTER):
+                trace_event(trace, EVENT_LOOP_ENTER, 0, 0, 0);
+                rodeo_clock_invalidate(&ctx->clock);
+                loops[ins->arg] = 0;
+                VM_NEXT;
+
+            VM_CASE(LOOP_NEXT):
+                rodeo_clock_invalidate(&ctx->clock);
+                if (++loops[ins->arg] > 10000) {
+                    fprintf(stderr, "  [WARNING] Loop exceeded 10000 iterations, breaking\n");
+                    pc++;
+                }
+                VM_NEXT;
+
+            VM_CASE(LOOP_EXIT):
+                trace_event(trace, EVENT_LOOP_EXIT, 0, 0, loops[ins->arg]);
+                VM_NEXT;
+
+            VM_CASE(SPEED):
+                vm_set_speed(ctx, stack[--sp]);
+                VM_NEXT;
+
+            VM_CASE(TORQUE):
+                vm_set_torque(ctx, stack[--sp]);
+                VM_NEXT;
+
+            VM_CASE(YAW):
+                vm_set_yaw(ctx, stack[--sp]);
+                VM_NEXT;
+
+            VM_CASE(BRAKE):
+                vm_set_brake(ctx, stack[--sp]);
+                VM_NEXT;
+
+            VM_CASE(WAIT):
+                {
+                    int wait_ms = stack[--sp];
+                    trace_event(trace, EVENT_WAIT, 0, 0, wait_ms);
+                    vm_wait(ctx, wait_ms);
+                }
+                VM_NEXT;
+
+            VM_CASE(PATTERN):
+                vm_set_pattern(ctx, (Pattern)ins->aux);
+                VM_NEXT;
+
+            VM_CASE(READ):
+                {
+                    int value = vm_read_sensor(ctx, (SensorType)ins->aux);
+                    registers[ins->arg] = value;
+                    trace_event(trace, EVENT_SENSOR, ins->aux, ins->arg, value);
+                }
+                VM_NEXT;
+
+            // Superinstructions: operands come from the unfused sequence after ins
+            VM_CASE(READ_BRANCH):
+                {
+                    int value = vm_read_sensor(ctx, (SensorType)ins->aux);
+                    registers[ins->arg] = value;
+                    trace_event(trace, EVENT_SENSOR, ins->aux, ins->arg, value);
+
+                    int cond_result = compare(ins[3].op, value, ins[2].arg);
+                    trace_event(trace, EVENT_IF, 0, 0, cond_result);
+                    pc = cond_result ? pc + 4 : ins[4].arg;
+                }
+                VM_NEXT;
+
+            VM_CASE(BRAKE_SPEED):
+                vm_set_brake(ctx, ins->arg);
+                vm_set_speed(ctx, ins[2].arg);
+                pc += 3;
+                VM_NEXT;
+
+            VM_CASE(SPEED_BRAKE):
+                vm_set_speed(ctx, ins->arg);
+                vm_set_brake(ctx, ins[2].arg);
+                pc += 3;
+                VM_NEXT;
+
+            VM_CASE(HALT):
+                return;
+        }
     }
 }
 
-void vm_execute(VMContext *ctx, ASTNode *program) {
-    printf("▶ Starting program execution...\n\n");
-    
-    ASTNode *current = program;
-    while (current) {
-        vm_execute_statement(ctx, current);
-        current = current->next;
+int vm_run_bytecode(VMContext *ctx, Bytecode *bc) {
+    TraceLog *trace = &ctx->trace;
+    if (trace->level != TRACE_OFF) {
+        printf("▶ Starting program execution...\n\n");
     }
-    
-    printf("\n✓ Program execution completed.\n");
+
+    vm_reserve_registers(ctx, bc->name_count);
+    ctx->names = bc->names;
+    ctx->var_count = bc->name_count;
+    if (ctx->time_mode == TIME_REAL) {
+        ctx->rodeo.start_time_us = rodeo_clock_read_source(ctx->clock.source);
+        rodeo_clock_invalidate(&ctx->clock);
+    }
+    trace->names = bc->names;
+    trace->name_count = bc->name_count;
+
+    int *stack = (int *)malloc(sizeof(int) * (bc->max_stack + 1));
+    int *loops = (int *)calloc(bc->loop_count + 1, sizeof(int));
+    if (!stack || !loops) {
+        fprintf(stderr, "Error: not enough memory to run the program\n");
+        free(loops);
+        free(stack);
+        return -1;
+    }
+
+    JitCode *jit = NULL;
+    if (ctx->engine == ENGINE_JIT) {
+        jit = jit_compile(bc, trace->level != TRACE_OFF);
+        if (!jit) fprintf(stderr, "Warning: JIT not available, using the interpreter\n");
+    }
+    if (jit) {
+        jit_run(jit, ctx, stack, loops);
+        jit_free(jit);
+    } else {
+        interpret(ctx, bc, stack, loops);
+    }
+    vm_flush_actuators(ctx);
+
+    free(loops);
+    free(stack);
+    trace_flush(trace);
+    if (trace->level == TRACE_SUMMARY) {
+        trace_print_summary(trace);
+    }
+    if (trace->level != TRACE_OFF) {
+        printf("\n✓ Program execution completed.\n");
+    }
+    return 0;
 }
 
 void vm_print_state(VMContext *ctx) {
@@ -292,6 +452,7 @@ void vm_print_state(VMContext *ctx) {
     printf("│ Tilt:      %3d°                            │\n", ctx->rodeo.tilt_angle);
     printf("│ RPM:       %4d                             │\n", ctx->rodeo.rpm);
     printf("│ Emergency: %-32s│\n", ctx->rodeo.emergency ? "🚨 ACTIVE" : "✓ OK");
+    printf("│ Time:      %-8ld ms                     │\n", ctx->rodeo.sim_time_ms);
     printf("└────────────────────────────────────────────┘\n");
     
     if (ctx->var_count > 0) {
@@ -300,17 +461,19 @@ void vm_print_state(VMContext *ctx) {
         printf("├────────────────────────────────────────────┤\n");
         for (int i = 0; i < ctx->var_count; i++) {
             printf("│ %-20s = %-18d│\n", 
-                   ctx->variables[i].name, 
-                   ctx->variables[i].value);
+                   ctx->names[i], 
+                   ctx->registers[i]);
         }
         printf("└────────────────────────────────────────────┘\n");
     }
 }
 
 void vm_cleanup(VMContext *ctx) {
-    for (int i = 0; i < ctx->var_count; i++) {
-        free(ctx->variables[i].name);
-    }
+    trace_close(&ctx->trace);
+    free(ctx->registers);
+    ctx->registers = NULL;
+    ctx->register_capacity = 0;
+    ctx->names = NULL;
     ctx->var_count = 0;
 }
 
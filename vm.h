@@ -2,15 +2,12 @@
 #define VM_H
 
 #include "ast.h"
+#include "clock.h"
+#include "compiler.h"
+#include "resolver.h"
+#include "trace.h"
 #include <time.h>
 
-#define MAX_VARIABLES 100
-
-typedef struct {
-    char *name;
-    int value;
-} Variable;
-
 typedef struct {
     int speed;          
     int torque;         
@@ -22,30 +19,135 @@ typedef struct {
     int tilt_angle;     
     int rpm;            
     int emergency;      
-    long start_time_ms; 
+    long start_time_us; // clock reading when the program started
+    long sim_time_ms;   // advanced by wait()
 } RodeoState;
 
+typedef enum {
+    TIME_VIRTUAL,       // wait() only advances the simulated clock
+    TIME_REAL           // wait() also sleeps, read(time_ms) reports elapsed real time
+} TimeMode;
+
+typedef enum {
+    ENGINE_INTERPRETER,
+    ENGINE_JIT          // native code where supported, the interpreter elsewhere
+} Engine;
+
+typedef struct VMContext VMContext;
+
+// Bits of VMFrame.changed
+enum {
+    VM_FRAME_SPEED = 1 << 0,
+    VM_FRAME_TORQUE = 1 << 1,
+    VM_FRAME_YAW = 1 << 2,
+    VM_FRAME_BRAKE = 1 << 3,
+    VM_FRAME_PATTERN = 1 << 4,
+    VM_FRAME_ALL = (1 << 5) - 1
+};
+
+// Actuator settings as the backend should have them; `changed` marks the ones
+// that differ from the previous frame. The first frame after vm_set_backend
+// marks them all, since the backend's own starting state is not known.
 typedef struct {
-    Variable variables[MAX_VARIABLES];
+    unsigned int changed;
+    int speed;
+    int torque;
+    int yaw;
+    int brake;
+    Pattern pattern;
+} VMFrame;
+
+// Where commands go and sensor readings come from. The VM keeps RodeoState and
+// the trace itself. Actuator writes are coalesced: just before a sensor read,
+// a wait and the end of the program the VM commits one frame with the final
+// value of every actuator that changed since the last one, so writes nothing
+// observed in between never reach the backend. Waits reach the backend after
+// the simulated clock has advanced, negative ones as wait(0). Every entry must
+// be set. Time sensors are always served by the VM.
+typedef struct {
+    const char *name;
+    int (*read_sensor)(VMContext *ctx, SensorType sensor);
+    void (*commit)(VMContext *ctx, const VMFrame *frame);
+    void (*wait)(VMContext *ctx, int ms);
+} VMBackend;
+
+// Without a backend the VM drives the built-in simulator inline, but in the
+// default build every actuator command and sensor read still tests for one.
+// Built with VM_STATIC_BACKEND (make BACKEND=static) the simulator is the
+// only option and those tests compile away entirely.
+#ifdef VM_STATIC_BACKEND
+#define VM_HAS_BACKEND(ctx) 0
+#else
+#define VM_HAS_BACKEND(ctx) ((ctx)->backend != NULL)
+#endif
+
+struct VMContext {
+    int *registers;     // sized to the running program by vm_reserve_registers
+    int register_capacity;
+    char **names;       // slot names of the running program
     int var_count;
     RodeoState rodeo;
-} VMContext;
+    TimeMode time_mode;
+    RodeoClock clock;   // read only in TIME_REAL mode
+    unsigned int seed;  // non-zero adds sensor noise
+    TraceLog trace;
+    Engine engine;
+    const VMBackend *backend;   // NULL for the built-in simulator
+    void *backend_data;
+    unsigned int pending;       // VM_FRAME_* bits written since the last commit
+    unsigned int unsynced;      // VM_FRAME_* bits never committed since vm_set_backend
+    VMFrame frame;              // last frame committed to the backend
+};
 
-void vm_init(VMContext *ctx);
-void vm_execute(VMContext *ctx, ASTNode *program);
+void vm_init(VMContext *ctx, TraceLevel trace_level);
+void vm_reserve_registers(VMContext *ctx, int count);
+// Returns -1 if the program's stack and loop counters cannot be allocated
+int vm_run_bytecode(VMContext *ctx, Bytecode *bc);
 void vm_print_state(VMContext *ctx);
 void vm_cleanup(VMContext *ctx);
+int vm_set_backend(VMContext *ctx, const VMBackend *backend, void *data);
 
-int vm_get_variable(VMContext *ctx, const char *name);
-void vm_set_variable(VMContext *ctx, const char *name, int value);
+void vm_wait(VMContext *ctx, int ms);
+void vm_flush_actuators(VMContext *ctx);
+int vm_read_sensor(VMContext *ctx, SensorType sensor);
+void vm_simulate_sensors(VMContext *ctx);
 
-int vm_eval_expression(VMContext *ctx, Expression *expr);
-int vm_eval_condition(VMContext *ctx, Condition *cond);
+// Actuator setters shared by the interpreter and the JIT
+static inline int vm_clamp_percent(int value) {
+    if (value < 0) return 0;
+    if (value > 100) return 100;
+    return value;
+}
 
-void vm_execute_statement(VMContext *ctx, ASTNode *stmt);
+static inline void vm_set_speed(VMContext *ctx, int speed) {
+    ctx->rodeo.speed = vm_clamp_percent(speed);
+    trace_event(&ctx->trace, EVENT_SPEED, 0, 0, ctx->rodeo.speed);
+    if (VM_HAS_BACKEND(ctx)) ctx->pending |= VM_FRAME_SPEED;
+}
 
-int vm_read_sensor(VMContext *ctx, SensorType sensor);
-void vm_simulate_sensors(VMContext *ctx);
+static inline void vm_set_torque(VMContext *ctx, int torque) {
+    ctx->rodeo.torque = vm_clamp_percent(torque);
+    trace_event(&ctx->trace, EVENT_TORQUE, 0, 0, ctx->rodeo.torque);
+    if (VM_HAS_BACKEND(ctx)) ctx->pending |= VM_FRAME_TORQUE;
+}
+
+static inline void vm_set_yaw(VMContext *ctx, int yaw) {
+    ctx->rodeo.yaw = yaw;
+    trace_event(&ctx->trace, EVENT_YAW, 0, 0, yaw);
+    if (VM_HAS_BACKEND(ctx)) ctx->pending |= VM_FRAME_YAW;
+}
+
+static inline void vm_set_brake(VMContext *ctx, int brake) {
+    ctx->rodeo.brake = brake ? 1 : 0;
+    trace_event(&ctx->trace, EVENT_BRAKE, 0, 0, ctx->rodeo.brake);
+    if (VM_HAS_BACKEND(ctx)) ctx->pending |= VM_FRAME_BRAKE;
+}
+
+static inline void vm_set_pattern(VMContext *ctx, Pattern pattern) {
+    ctx->rodeo.pattern = pattern;
+    trace_event(&ctx->trace, EVENT_PATTERN, pattern, 0, 0);
+    if (VM_HAS_BACKEND(ctx)) ctx->pending |= VM_FRAME_PATTERN;
+}
 
 #endif
 